@@ -0,0 +1,176 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "AsyncObserver.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include "NameTable.h"
+#include "PFPContext.h"
+
+namespace pfp {
+namespace core {
+
+namespace {
+//! Failed pops before the dispatch thread goes to sleep
+const unsigned spins_before_sleep = 64;
+//! Longest sleep of the dispatch thread, bounds the latency of a lost wake
+const std::chrono::milliseconds max_sleep(1);
+
+/**
+ * What the dispatch thread gets in place of the model's data: its id and
+ * type, taken when the event is queued, since the model keeps using (and
+ * changing) the original while the event waits in the ring
+ */
+class DataSnapshot : public TrType {
+ public:
+  explicit DataSnapshot(const TrType& data)
+    : TrType(data.id()),
+      data_type_(NameTable::get().intern(data.data_type())) {}
+
+  std::string data_type() const override {
+    return NameTable::get().name(data_type_);
+  }
+
+ private:
+  NameTable::Id data_type_;
+};
+}  // namespace
+
+AsyncObserver::AsyncObserver(std::shared_ptr<PFPObserver> observer,
+      std::size_t capacity, Overflow overflow, std::size_t sample_period)
+  : observer_(observer), ring_(capacity), overflow_(overflow),
+    sample_period_(sample_period ? sample_period : 1), sample_count_(0),
+    accepted_(0), dispatched_(0), dropped_(0), stop_(false),
+    sleeping_(false) {
+  end_of_simulation_handle_ = PFPContext::get_current_context()
+        .at_end_of_simulation([this]() { flush(); },
+              PFPContext::EndPhase::Drain);
+  thread_ = std::thread(&AsyncObserver::run, this);
+}
+
+AsyncObserver::~AsyncObserver() {
+  PFPContext::get_current_context().cancel_end_of_simulation(
+        end_of_simulation_handle_);
+  stop_.store(true, std::memory_order_release);
+  wake();
+  thread_.join();
+}
+
+void AsyncObserver::observe(const ObserverEvent& event) {
+  ObserverEvent copy(event);
+  if (copy.data) {
+    copy.data = std::make_shared<DataSnapshot>(*event.data);
+  }
+  switch (overflow_) {
+    case Overflow::Block:
+      while (!ring_.try_push(std::move(copy))) {
+        wake();
+        std::this_thread::yield();
+      }
+      break;
+    case Overflow::DropOldest:
+      while (!ring_.try_push(std::move(copy))) {
+        ObserverEvent oldest;
+        if (ring_.try_pop(oldest)) {
+          --accepted_;
+          dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+      break;
+    case Overflow::Sample:
+      if (ring_.size() >= ring_.capacity() / 2
+            && ++sample_count_ % sample_period_ != 0) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      if (!ring_.try_push(std::move(copy))) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      break;
+  }
+  ++accepted_;
+  if (sleeping_.load(std::memory_order_relaxed)) {
+    wake();
+  }
+}
+
+void AsyncObserver::flush() {
+  wake();
+  while (dispatched_.load(std::memory_order_acquire) != accepted_) {
+    std::this_thread::yield();
+  }
+}
+
+void AsyncObserver::histogram_summary(const std::string& module_name,
+      const std::string& histogram_name, const Histogram& histogram,
+      double simulation_time) {
+  // Once flushed the dispatch thread is idle, so calling the wrapped
+  // observer from here does not race with it
+  flush();
+  observer_->histogram_summary(module_name, histogram_name, histogram,
+        simulation_time);
+}
+
+void AsyncObserver::run() {
+  ObserverEvent event;
+  unsigned idle = 0;
+  for (;;) {
+    if (ring_.try_pop(event)) {
+      observer_->observe(event);
+      event.data.reset();
+      dispatched_.fetch_add(1, std::memory_order_release);
+      idle = 0;
+    } else if (stop_.load(std::memory_order_acquire)) {
+      // Everything pushed before stop_ was set is visible now
+      if (ring_.empty()) {
+        return;
+      }
+    } else if (++idle < spins_before_sleep) {
+      std::this_thread::yield();
+    } else {
+      std::unique_lock<std::mutex> lock(mutex_);
+      sleeping_.store(true, std::memory_order_relaxed);
+      wake_.wait_for(lock, max_sleep);
+      sleeping_.store(false, std::memory_order_relaxed);
+    }
+  }
+}
+
+void AsyncObserver::wake() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  wake_.notify_one();
+}
+
+};  // namespace core
+};  // namespace pfp
@@ -0,0 +1,145 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class AsyncObserver
+ * Runs another observer on a dedicated OS thread.
+ * The AsyncObserver is attached in place of the observer it wraps. Its
+ * observe() only copies the event into a lock-free ring; a host thread pops
+ * the ring and calls the wrapped observer, so expensive observers (tracing,
+ * statistics) run concurrently with the SystemC scheduler instead of in
+ * between model processes. Several AsyncObservers give several threads.
+ *
+ * The wrapped observer sees the events in order, from a single thread, but
+ * concurrently with the simulation, so it must not call into the model. It
+ * never sees the model's data either: event data is replaced by a copy of
+ * its id() and data_type() when the event is queued. The ring is flushed in
+ * the Drain phase at the end of the simulation, before any observer writes
+ * its results (see PFPContext::at_end_of_simulation), and when the
+ * AsyncObserver is destroyed.
+ *
+ *   auto tracer = std::make_shared<MyTracer>();
+ *   top->attach_observer(std::make_shared<AsyncObserver>(tracer));
+ */
+#ifndef CORE_ASYNCOBSERVER_H_
+#define CORE_ASYNCOBSERVER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "ConcurrentRing.h"
+#include "EventObserver.h"
+#include "ObserverEvent.h"
+
+namespace pfp {
+namespace core {
+
+class AsyncObserver : public EventObserver {
+ public:
+  //! What observe() does when the ring is full
+  enum class Overflow {
+    Block,        /*!< Wait for the dispatch thread; no event is lost */
+    DropOldest,   /*!< Evict the oldest queued event to make room */
+    Sample        /*!< Past half full, only keep one event in sample_period */
+  };
+
+  /**
+   * Construct an AsyncObserver and start its dispatch thread
+   * @param observer       Observer to run on the dispatch thread
+   * @param capacity       Number of events the ring can hold
+   * @param overflow       Overflow policy
+   * @param sample_period  Events kept under Overflow::Sample, one in this
+   */
+  explicit AsyncObserver(std::shared_ptr<PFPObserver> observer,
+        std::size_t capacity = 65536, Overflow overflow = Overflow::Block,
+        std::size_t sample_period = 16);
+  ~AsyncObserver();
+
+  /**
+   * Queue an event for the dispatch thread
+   * @param event      Event to hand over
+   */
+  void observe(const ObserverEvent& event) override;
+
+  uint32_t interests() const override {
+    return observer_->interests();
+  }
+
+  bool dispatch_inline() const override {
+    return true;
+  }
+
+  /**
+   * Flush the ring, then pass the summary on to the wrapped observer
+   */
+  void histogram_summary(const std::string& module_name,
+        const std::string& histogram_name, const Histogram& histogram,
+        double simulation_time) override;
+
+  /**
+   * Wait until the dispatch thread has handled every queued event
+   */
+  void flush();
+
+  /**
+   * Number of events discarded by the overflow policy
+   */
+  std::size_t dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void run();
+  void wake();
+
+  std::shared_ptr<PFPObserver> observer_;  /*!< Observer being dispatched */
+  ConcurrentRing<ObserverEvent> ring_;
+  const Overflow overflow_;
+  const std::size_t sample_period_;
+  std::size_t sample_count_;     /*!< Producer side: events seen in Sample */
+  std::size_t accepted_;         /*!< Producer side: events left in the ring */
+  std::atomic<std::size_t> dispatched_;   /*!< Events handled by run() */
+  std::atomic<std::size_t> dropped_;
+  std::atomic<bool> stop_;
+  std::atomic<bool> sleeping_;   /*!< Dispatch thread is waiting on wake_ */
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::size_t end_of_simulation_handle_;
+  std::thread thread_;           /*!< Dispatch thread, started last */
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_ASYNCOBSERVER_H_
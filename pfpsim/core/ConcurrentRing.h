@@ -0,0 +1,191 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class ConcurrentRing
+ * Bounded lock-free FIFO shared between OS threads, with a power-of-two
+ * number of slots allocated once at construction.
+ * Each slot carries a sequence number that tells producers and consumers
+ * whether it is free or holds an element (D. Vyukov's bounded queue), so any
+ * number of threads may push and pop concurrently. The AsyncObserver uses
+ * it with the SystemC thread as the producer and one dispatch thread as the
+ * consumer; the producer also pops to evict the oldest element when it
+ * overflows.
+ */
+#ifndef CORE_CONCURRENTRING_H_
+#define CORE_CONCURRENTRING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace pfp {
+namespace core {
+
+template <typename T>
+class ConcurrentRing {
+ public:
+  /**
+   * Construct a ConcurrentRing
+   * @param min_capacity  Number of elements the ring must be able to hold,
+   *                      rounded up to the next power of two
+   */
+  explicit ConcurrentRing(std::size_t min_capacity)
+  : mask_(round_up_pow2(min_capacity) - 1),
+    cells_(new Cell[mask_ + 1]), enqueue_pos_(0), dequeue_pos_(0) {
+    for (std::size_t i = 0; i <= mask_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  ConcurrentRing(const ConcurrentRing&) = delete;
+  ConcurrentRing& operator=(const ConcurrentRing&) = delete;
+
+  ~ConcurrentRing() {
+    T item;
+    while (try_pop(item)) {
+    }
+  }
+
+  /**
+   * Move an element into the ring if there is room
+   * @param item  Element to push; left untouched if the ring is full
+   * @return      True if the element was pushed
+   */
+  bool try_push(T&& item) {
+    Cell* cell;
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq)
+            - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+              std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    new (cell->element()) T(std::move(item));
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Move the oldest element out of the ring if there is one
+   * @param item  Output argument
+   * @return      True if an element was popped
+   */
+  bool try_pop(T& item) {
+    Cell* cell;
+    std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq)
+            - static_cast<std::ptrdiff_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+              std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    item = std::move(*cell->element());
+    cell->element()->~T();
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Number of elements in the ring; only a snapshot while other threads
+   * are pushing or popping
+   */
+  std::size_t size() const {
+    const std::size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+    const std::size_t head = dequeue_pos_.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+
+  std::size_t capacity() const {
+    return mask_ + 1;
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> sequence;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+    T* element() {
+      return reinterpret_cast<T*>(&storage);
+    }
+  };
+
+  static std::size_t round_up_pow2(std::size_t n) {
+    std::size_t capacity = 1;
+    while (capacity < n) {
+      capacity <<= 1;
+    }
+    return capacity;
+  }
+
+  //! Padding to keep the producer and consumer positions on separate lines
+  typedef char CacheLinePad[64];
+
+  const std::size_t mask_;          /*!< capacity - 1 */
+  std::unique_ptr<Cell[]> cells_;   /*!< Preallocated element storage */
+  CacheLinePad pad0_;
+  std::atomic<std::size_t> enqueue_pos_;  /*!< Next position to push */
+  CacheLinePad pad1_;
+  std::atomic<std::size_t> dequeue_pos_;  /*!< Next position to pop */
+  CacheLinePad pad2_;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_CONCURRENTRING_H_
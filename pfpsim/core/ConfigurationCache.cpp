@@ -0,0 +1,445 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "ConfigurationCache.h"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pfp {
+namespace core {
+
+namespace {
+/*
+ * Snapshot layout, all fields in host byte order:
+ *   magic "PFPCFGS1", uint32 version, uint32 document, file and combined
+ *   counts; the documents; the files (string path, uint64 size, int64
+ *   mtime seconds and nanoseconds, uint32 document); the MatchandFill
+ *   results (uint32 base, instance and result documents).
+ * Strings are a uint32 length and the bytes. A json value is a type byte
+ * followed by: nothing (null), a byte (boolean), an int64, uint64 or
+ * double (numbers), a string, or a uint32 count and the elements (array)
+ * or the key string and value of each member (object).
+ */
+const char snapshot_magic[8] = {'P', 'F', 'P', 'C', 'F', 'G', 'S', '1'};
+const uint32_t snapshot_version = 1;
+
+enum class ValueType : uint8_t {
+  Null, False, True, Integer, Unsigned, Float, String, Array, Object
+};
+
+class SnapshotWriter {
+ public:
+  template <typename T>
+  void put(T value) {
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  void put_string(const std::string& value) {
+    put(static_cast<uint32_t>(value.size()));
+    buffer_.append(value);
+  }
+
+  void put_value(const ConfigurationCache::Document& value) {
+    typedef ConfigurationCache::Document::value_t Type;
+    switch (value.type()) {
+      case Type::boolean:
+        put(value.get<bool>() ? ValueType::True : ValueType::False);
+        break;
+      case Type::number_integer:
+        put(ValueType::Integer);
+        put(value.get<int64_t>());
+        break;
+      case Type::number_unsigned:
+        put(ValueType::Unsigned);
+        put(value.get<uint64_t>());
+        break;
+      case Type::number_float:
+        put(ValueType::Float);
+        put(value.get<double>());
+        break;
+      case Type::string:
+        put(ValueType::String);
+        put_string(value.get<std::string>());
+        break;
+      case Type::array:
+        put(ValueType::Array);
+        put(static_cast<uint32_t>(value.size()));
+        for (auto& element : value) {
+          put_value(element);
+        }
+        break;
+      case Type::object:
+        put(ValueType::Object);
+        put(static_cast<uint32_t>(value.size()));
+        for (auto it = value.cbegin(); it != value.cend(); ++it) {
+          put_string(it.key());
+          put_value(it.value());
+        }
+        break;
+      default:
+        put(ValueType::Null);
+        break;
+    }
+  }
+
+  const std::string& buffer() const {
+    return buffer_;
+  }
+
+ private:
+  std::string buffer_;
+};
+
+class SnapshotReader {
+ public:
+  explicit SnapshotReader(const std::string& buffer)
+  : next_(buffer.data()), end_(buffer.data() + buffer.size()) {
+  }
+
+  template <typename T>
+  bool get(T* value) {
+    if (static_cast<std::size_t>(end_ - next_) < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(value, next_, sizeof(T));
+    next_ += sizeof(T);
+    return true;
+  }
+
+  bool get_string(std::string* value) {
+    uint32_t length;
+    if (!get(&length) || static_cast<std::size_t>(end_ - next_) < length) {
+      return false;
+    }
+    value->assign(next_, length);
+    next_ += length;
+    return true;
+  }
+
+  bool get_value(ConfigurationCache::Document* value) {
+    typedef ConfigurationCache::Document Document;
+    ValueType type;
+    if (!get(&type)) {
+      return false;
+    }
+    switch (type) {
+      case ValueType::Null:
+        *value = nullptr;
+        return true;
+      case ValueType::False:
+      case ValueType::True:
+        *value = (type == ValueType::True);
+        return true;
+      case ValueType::Integer:
+        return get_number<int64_t>(value);
+      case ValueType::Unsigned:
+        return get_number<uint64_t>(value);
+      case ValueType::Float:
+        return get_number<double>(value);
+      case ValueType::String: {
+        std::string string;
+        if (!get_string(&string)) {
+          return false;
+        }
+        *value = string;
+        return true;
+      }
+      case ValueType::Array: {
+        uint32_t count;
+        if (!get(&count)) {
+          return false;
+        }
+        *value = Document::array();
+        for (uint32_t i = 0; i < count; ++i) {
+          Document element;
+          if (!get_value(&element)) {
+            return false;
+          }
+          value->push_back(std::move(element));
+        }
+        return true;
+      }
+      case ValueType::Object: {
+        uint32_t count;
+        if (!get(&count)) {
+          return false;
+        }
+        *value = Document::object();
+        for (uint32_t i = 0; i < count; ++i) {
+          std::string key;
+          Document member;
+          if (!get_string(&key) || !get_value(&member)) {
+            return false;
+          }
+          (*value)[key] = std::move(member);
+        }
+        return true;
+      }
+      default:
+        return false;
+    }
+  }
+
+  bool at_end() const {
+    return next_ == end_;
+  }
+
+ private:
+  template <typename T>
+  bool get_number(ConfigurationCache::Document* value) {
+    T number;
+    if (!get(&number)) {
+      return false;
+    }
+    *value = number;
+    return true;
+  }
+
+  const char* next_;
+  const char* end_;
+};
+}  // namespace
+
+ConfigurationCache& ConfigurationCache::get() {
+  static ConfigurationCache instance;
+  return instance;
+}
+
+bool ConfigurationCache::stamp(const std::string& filename,
+      FileStamp* stamp) {
+  struct stat info;
+  if (::stat(filename.c_str(), &info) != 0) {
+    return false;
+  }
+  stamp->size = static_cast<uint64_t>(info.st_size);
+  stamp->mtime_sec = static_cast<int64_t>(info.st_mtim.tv_sec);
+  stamp->mtime_nsec = static_cast<int64_t>(info.st_mtim.tv_nsec);
+  return true;
+}
+
+ConfigurationCache::DocumentPtr ConfigurationCache::load(
+      const std::string& filename) {
+  FileStamp file_stamp;
+  if (!stamp(filename, &file_stamp)) {
+    return nullptr;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = files_.find(filename);
+    if (it != files_.end() && it->second.stamp == file_stamp) {
+      ++hits_;
+      return it->second.document;
+    }
+  }
+  std::ifstream ifs(filename);
+  if (ifs.fail()) {
+    return nullptr;
+  }
+  std::string content((std::istreambuf_iterator<char>(ifs)),
+                      (std::istreambuf_iterator<char>()));
+  DocumentPtr document;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = documents_.find(content);
+    if (it != documents_.end()) {
+      ++hits_;
+      document = it->second;
+    }
+  }
+  if (!document) {
+    // Parse outside the lock; a concurrent load of the same content keeps
+    // whichever document is inserted first
+    document = std::make_shared<const Document>(Document::parse(content));
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++parsed_;
+    document = documents_.emplace(std::move(content), document).first->second;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  files_[filename] = LoadedFile{file_stamp, document};
+  return document;
+}
+
+bool ConfigurationCache::save_snapshot(const std::string& filename) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Number every document referenced by a file or a MatchandFill result
+  std::unordered_map<const Document*, uint32_t> index;
+  std::vector<const Document*> documents;
+  auto number = [&](const DocumentPtr& document) {
+    auto it = index.emplace(document.get(),
+          static_cast<uint32_t>(documents.size()));
+    if (it.second) {
+      documents.push_back(document.get());
+    }
+    return it.first->second;
+  };
+  for (auto& file : files_) {
+    number(file.second.document);
+  }
+  for (auto& each : combined_) {
+    number(each.second.base);
+    number(each.second.overrides);
+    number(each.second.result);
+  }
+
+  SnapshotWriter out;
+  for (char c : snapshot_magic) {
+    out.put(c);
+  }
+  out.put(snapshot_version);
+  out.put(static_cast<uint32_t>(documents.size()));
+  out.put(static_cast<uint32_t>(files_.size()));
+  out.put(static_cast<uint32_t>(combined_.size()));
+  for (auto document : documents) {
+    out.put_value(*document);
+  }
+  for (auto& file : files_) {
+    out.put_string(file.first);
+    out.put(file.second.stamp.size);
+    out.put(file.second.stamp.mtime_sec);
+    out.put(file.second.stamp.mtime_nsec);
+    out.put(index[file.second.document.get()]);
+  }
+  for (auto& each : combined_) {
+    out.put(index[each.second.base.get()]);
+    out.put(index[each.second.overrides.get()]);
+    out.put(index[each.second.result.get()]);
+  }
+
+  // Write beside the snapshot and rename over it, so that a run reading the
+  // snapshot (e.g. another sweep point) never sees a partial file
+  const std::string temporary = filename + ".tmp."
+        + std::to_string(getpid());
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(out.buffer().data(), out.buffer().size());
+    file.close();
+    if (file.fail()) {
+      std::remove(temporary.c_str());
+      return false;
+    }
+  }
+  if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool ConfigurationCache::load_snapshot(const std::string& filename) {
+  std::ifstream file(filename, std::ios::binary);
+  if (file.fail()) {
+    return false;
+  }
+  const std::string buffer((std::istreambuf_iterator<char>(file)),
+                           (std::istreambuf_iterator<char>()));
+  SnapshotReader in(buffer);
+
+  char magic[sizeof(snapshot_magic)];
+  uint32_t version, document_count, file_count, combined_count;
+  for (char& c : magic) {
+    if (!in.get(&c)) {
+      return false;
+    }
+  }
+  if (std::memcmp(magic, snapshot_magic, sizeof(magic)) != 0
+        || !in.get(&version) || version != snapshot_version
+        || !in.get(&document_count) || !in.get(&file_count)
+        || !in.get(&combined_count)) {
+    return false;
+  }
+
+  std::vector<DocumentPtr> documents;
+  documents.reserve(document_count);
+  for (uint32_t i = 0; i < document_count; ++i) {
+    Document document;
+    if (!in.get_value(&document)) {
+      return false;
+    }
+    documents.push_back(std::make_shared<const Document>(
+          std::move(document)));
+  }
+
+  std::map<std::string, LoadedFile> files;
+  for (uint32_t i = 0; i < file_count; ++i) {
+    std::string path;
+    LoadedFile loaded;
+    uint32_t document;
+    if (!in.get_string(&path) || !in.get(&loaded.stamp.size)
+          || !in.get(&loaded.stamp.mtime_sec)
+          || !in.get(&loaded.stamp.mtime_nsec) || !in.get(&document)
+          || document >= documents.size()) {
+      return false;
+    }
+    // Out of date as soon as one source file changed or disappeared
+    FileStamp current;
+    if (!stamp(path, &current) || !(current == loaded.stamp)) {
+      return false;
+    }
+    loaded.document = documents[document];
+    files.emplace(std::move(path), std::move(loaded));
+  }
+
+  std::vector<Combined> combined;
+  for (uint32_t i = 0; i < combined_count; ++i) {
+    uint32_t base, overrides, result;
+    if (!in.get(&base) || !in.get(&overrides) || !in.get(&result)
+          || base >= documents.size() || overrides >= documents.size()
+          || result >= documents.size()) {
+      return false;
+    }
+    combined.push_back(Combined{documents[base], documents[overrides],
+          documents[result]});
+  }
+  if (!in.at_end()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& file : files) {
+    files_[file.first] = file.second;
+  }
+  for (auto& each : combined) {
+    combined_.emplace(std::make_pair(each.base.get(), each.overrides.get()),
+          each);
+  }
+  return true;
+}
+
+};  // namespace core
+};  // namespace pfp
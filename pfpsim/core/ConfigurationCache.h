@@ -0,0 +1,181 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class ConfigurationCache
+ * Process-wide cache of parsed configuration documents.
+ * Documents are keyed by the content of the file they were parsed from, so
+ * every copy of a configuration file is parsed once however many module
+ * instances load it, and whatever path they load it from. Parsed documents
+ * are immutable and shared by all ConfigurationParameterNodes that use them
+ * (copy-on-write: a node that needs a different document builds a new one).
+ * The result of filling a base document with an instance document
+ * (ConfigurationParameterNode::MatchandFill) is cached as well, keyed by
+ * the two documents, so identical instances share it too.
+ *
+ * The cache can be saved to a binary snapshot once elaboration has loaded
+ * the whole configuration (see the --config-snapshot option of the
+ * simulation). A later run that loads the snapshot gets every document
+ * and every validated MatchandFill result from a single read, without
+ * opening the configuration files. The snapshot records the size and
+ * modification time of each source file and is rejected as a whole if
+ * any of them changed.
+ */
+#ifndef CORE_CONFIGURATIONCACHE_H_
+#define CORE_CONFIGURATIONCACHE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "json.hpp"
+
+namespace pfp {
+namespace core {
+
+class ConfigurationCache {
+ public:
+  typedef nlohmann::json Document;
+  typedef std::shared_ptr<const Document> DocumentPtr;
+
+  /**
+   * Get a reference to the configuration cache
+   * @return  Singleton reference to the configuration cache
+   */
+  static ConfigurationCache& get();
+
+  /**
+   * Get the parsed content of a file, parsing it on the first use of that
+   * content
+   * @param filename  Path of the json file
+   * @return          Shared document; nullptr if the file cannot be read
+   */
+  DocumentPtr load(const std::string& filename);
+
+  /**
+   * Get a memoized result of combining two documents
+   * @param base      First document
+   * @param overrides Second document
+   * @param combine   Function computing the result on a cache miss
+   * @return          Shared result
+   */
+  template <typename Combine>
+  DocumentPtr combine(const DocumentPtr& base, const DocumentPtr& overrides,
+        Combine combine) {
+    const auto key = std::make_pair(base.get(), overrides.get());
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = combined_.find(key);
+      if (it != combined_.end()) {
+        return it->second.result;
+      }
+    }
+    Combined entry{base, overrides, std::make_shared<const Document>(
+          combine(*base, *overrides))};
+    std::lock_guard<std::mutex> lock(mutex_);
+    return combined_.emplace(key, entry).first->second.result;
+  }
+
+  /**
+   * Write all loaded documents, the files they came from and the
+   * MatchandFill results to a snapshot file
+   * @param filename  Path of the snapshot
+   * @return          False if the file cannot be written
+   */
+  bool save_snapshot(const std::string& filename);
+
+  /**
+   * Add the content of a snapshot to the cache
+   * @param filename  Path of the snapshot
+   * @return          False, leaving the cache unchanged, if the snapshot is
+   *                  missing, of another version, corrupt, or out of date
+   *                  with one of its source files
+   */
+  bool load_snapshot(const std::string& filename);
+
+  //! Number of files parsed, i.e. of cache misses of load()
+  std::size_t parsed() const {
+    return parsed_;
+  }
+
+  //! Number of load() calls served without parsing
+  std::size_t hits() const {
+    return hits_;
+  }
+
+ private:
+  ConfigurationCache() = default;
+  ConfigurationCache(const ConfigurationCache &) = delete;
+  ConfigurationCache& operator=(const ConfigurationCache &) = delete;
+
+  //! Identity of a file's content, as far as the file system tells
+  struct FileStamp {
+    uint64_t size;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    bool operator==(const FileStamp& other) const {
+      return size == other.size && mtime_sec == other.mtime_sec
+            && mtime_nsec == other.mtime_nsec;
+    }
+  };
+
+  struct LoadedFile {
+    FileStamp stamp;
+    DocumentPtr document;
+  };
+
+  static bool stamp(const std::string& filename, FileStamp* stamp);
+
+  struct Combined {
+    DocumentPtr base;       /*!< Inputs, kept alive so that their addresses */
+    DocumentPtr overrides;  /*!< cannot be reused by other documents */
+    DocumentPtr result;
+  };
+
+  std::mutex mutex_;   /*!< Guard */
+  //! Parsed documents by file content
+  std::unordered_map<std::string, DocumentPtr> documents_;
+  //! Document of each file loaded so far, or read from a snapshot; a file
+  //! with an unchanged stamp is not read again
+  std::map<std::string, LoadedFile> files_;
+  //! MatchandFill results by (base, instance) document
+  std::map<std::pair<const Document*, const Document*>, Combined> combined_;
+  std::size_t parsed_ = 0;
+  std::size_t hits_ = 0;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_CONFIGURATIONCACHE_H_
@@ -29,20 +29,18 @@
  */
 
 #include "ConfigurationParameters.h"
+#include <memory>
 #include <string>
+#include <utility>
 #include "PFPObject.h"
 #include "promptcolors.h"
 
 namespace pfp {
 namespace core {
 
-ConfigurationParameterNode::ConfigurationParameterNode(std::string filename) {
-  std::ifstream ifs(filename);
-  if (!ifs.fail()) {
-    std::string content((std::istreambuf_iterator<char>(ifs)),
-                        (std::istreambuf_iterator<char>()));
-    ConfigurationParameters = json::parse(content);
-  } else {
+ConfigurationParameterNode::ConfigurationParameterNode(std::string filename)
+      :ConfigurationParameters(ConfigurationCache::get().load(filename)) {
+  if (!ConfigurationParameters) {
     std::cerr << On_Purple << "Could not open file: " << txtrst << On_Red
           << filename << txtrst << std::endl;
     exit(-1);
@@ -51,16 +49,26 @@ ConfigurationParameterNode::ConfigurationParameterNode(std::string filename) {
 
 ConfigurationParameterNode::ConfigurationParameterNode(
       ConfigurationParameterNode::Matrix object)
-      :ConfigurationParameters(object) {
+      :ConfigurationParameters(std::make_shared<const Matrix>(
+            std::move(object))) {
+}
+
+ConfigurationParameterNode::ConfigurationParameterNode(
+      std::shared_ptr<const Matrix> document)
+      :ConfigurationParameters(std::move(document)) {
 }
 
 ConfigurationParameterNode::ConfigurationParameterNode()
-      :ConfigurationParameters(nullptr) {
+      :ConfigurationParameters(std::make_shared<const Matrix>(nullptr)) {
 }
 
 ConfigurationParameterNode::Matrix
 ConfigurationParameterNode::Searchinparent(std::string param,
       pfp::core::PFPObject* CurrentModule) {
+  // Index built by PFPObject::ResolveParameters covers the whole chain
+  if (auto value = CurrentModule->FindResolvedParameter(param)) {
+    return *value;
+  }
   std::string name = CurrentModule->module_name();
   std::size_t found = name.find("top");
   // Current Module is not Top, its parent might be top
@@ -116,19 +124,19 @@ ConfigurationParameterNode::Searchinparent(int position,
 
 ConfigurationParameterNode::Matrix
 ConfigurationParameterNode::HeirarchalSearch(std::string param) {
-  for (json::iterator it = ConfigurationParameters.begin();
-        it != ConfigurationParameters.end(); ++it) {
-     if (it.key() == param) {
-         return it.value();
-     }
+  if (ConfigurationParameters->is_object()) {
+    auto it = ConfigurationParameters->find(param);
+    if (it != ConfigurationParameters->end()) {
+      return it.value();
+    }
   }
 
   // No Match go to a parent
   sc_object* current_scmodule
         = sc_get_current_process_handle().get_parent_object();
-  if (dynamic_cast<pfp::core::PFPObject*>(current_scmodule)) {
-    return Searchinparent(param,
-          dynamic_cast<pfp::core::PFPObject*>(current_scmodule)->GetParent());
+  auto current_module = dynamic_cast<pfp::core::PFPObject*>(current_scmodule);
+  if (current_module) {
+    return Searchinparent(param, current_module->GetParent());
   } else {
     std::cerr << On_Red << "[PFPSIM runtime error]: " << txtrst
           << "Not in a PFPSIM module heirarichal search for param: "
@@ -139,8 +147,8 @@ ConfigurationParameterNode::HeirarchalSearch(std::string param) {
 
 ConfigurationParameterNode::Matrix
 ConfigurationParameterNode::HeirarchalSearch(int position) {
-  if (position < ConfigurationParameters.size()) {
-      return ConfigurationParameters.at(position);
+  if (position < ConfigurationParameters->size()) {
+      return ConfigurationParameters->at(position);
   } else {
     sc_object* current_scmodule
           = sc_get_current_process_handle().get_parent_object();
@@ -158,26 +166,26 @@ ConfigurationParameterNode::HeirarchalSearch(int position) {
 
 ConfigurationParameterNode::Matrix
 ConfigurationParameterNode::LocalSearch(std::string param) {
-  for (json::iterator it = ConfigurationParameters.begin();
-        it != ConfigurationParameters.end(); ++it) {
-     if (it.key() == param) {
-         return it.value();
-     }
+  if (ConfigurationParameters->is_object()) {
+    auto it = ConfigurationParameters->find(param);
+    if (it != ConfigurationParameters->end()) {
+      return it.value();
+    }
   }
   return nullptr;  // Search Failed return a nullptr
 }
 
 ConfigurationParameterNode::Matrix
 ConfigurationParameterNode::LocalSearch(int position) {
-  if (position < ConfigurationParameters.size()) {
-      return ConfigurationParameters.at(position);
+  if (position < ConfigurationParameters->size()) {
+      return ConfigurationParameters->at(position);
   } else {
     return nullptr;  // Search failed return a nullptr
   }
 }
 
 ConfigurationParameterNode::Matrix ConfigurationParameterNode::get() {
-  return ConfigurationParameters;
+  return *ConfigurationParameters;
 }
 
 
@@ -244,18 +252,18 @@ ConfigurationParameterNode::CompareStructure(
 ConfigurationParameterNode
 ConfigurationParameterNode::MatchandFill(
       ConfigurationParameterNode matchagainst) {
-  auto compareresult = CompareStructure(matchagainst.get(),
-        ConfigurationParameters);
-
-  if (compareresult.result) {
+  // Instances of a module usually share both files: fill once, share
+  return ConfigurationParameterNode(ConfigurationCache::get().combine(
+        ConfigurationParameters, matchagainst.ConfigurationParameters,
+        [this](const Matrix& golden, const Matrix& instance) {
+    auto compareresult = CompareStructure(instance, golden);
+    if (!compareresult.result) {
+      raiseError("Config File Match & Fill Internal Error - [Unreacheable state] -- Uncaught Error in Compare Structure");  // NOLINT(whitespace/line_length)
+    }
     // cout<<On_Blue<<"Golden obj filled with Instance objects: "<<txtrst<<endl
     //     <<compareresult.resultobject<<endl;
     return compareresult.resultobject;
-  } else {
-    raiseError("Config File Match & Fill Internal Error - [Unreacheable state] -- Uncaught Error in Compare Structure");  // NOLINT(whitespace/line_length)
-  }
-  // Statment is never reached just added to stop clang complaining.
-  return(ConfigurationParameterNode(json(nullptr)));
+  }));
 }
 
 void ConfigurationParameterNode::raiseError(std::string message,
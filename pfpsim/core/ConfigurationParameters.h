@@ -37,8 +37,11 @@
 
 #include <iostream>
 #include <fstream>
+#include <memory>
 #include <string>
 #include "json.hpp"
+#include "ConfigurationCache.h"
+#include "ParameterView.h"
 using json = nlohmann::json;
 
 namespace pfp{
@@ -49,8 +52,11 @@ class ConfigurationParameterNode {
  public:
   typedef json Matrix;  // Dom representation is in json format using json lib.
 
+  //! Load a file through the ConfigurationCache
   explicit ConfigurationParameterNode(std::string filename);
   ConfigurationParameterNode(Matrix object);  // NOLINT(runtime/explicit)
+  //! Share an already parsed document
+  explicit ConfigurationParameterNode(std::shared_ptr<const Matrix> document);
   ConfigurationParameterNode();
 
   /**
@@ -79,10 +85,25 @@ class ConfigurationParameterNode {
    * @return [object of json type]
    */
   Matrix get();
+  /**
+   * View of the document, for indexing without copying (see ParameterView);
+   * LocalSearch, HeirarchalSearch and operator[] return copies
+   * @return [view of the whole document]
+   */
+  ParameterView view() const {
+    return ParameterView(ConfigurationParameters);
+  }
+  /**
+   * Access the json object without copying it
+   * @return [reference to the object, valid until the node is modified]
+   */
+  const Matrix& get_ref() const {
+    return *ConfigurationParameters;
+  }
 
   template<typename T>
   T get() {
-    return ConfigurationParameters.get<T>();
+    return ConfigurationParameters->get<T>();
   }
 
   Matrix LocalSearch(std::string param);
@@ -105,8 +126,9 @@ class ConfigurationParameterNode {
   void raiseError(std::string);
 
  private:
-  /*Variable that stores the JSON/XML DOM object*/
-  Matrix ConfigurationParameters;
+  /*Variable that stores the JSON/XML DOM object; immutable, and shared
+    between copies of the node and nodes loaded from the same content*/
+  std::shared_ptr<const Matrix> ConfigurationParameters;
 };
 };  // namespace core
 };  // namespace pfp
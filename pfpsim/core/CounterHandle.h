@@ -0,0 +1,79 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class CounterHandle
+ * Reference to a counter of a PFPObject, returned by register_counter.
+ * Updating a counter through its handle indexes straight into the module's
+ * counter storage instead of looking the counter up by name. A
+ * default-constructed handle, or the handle returned when register_counter
+ * finds an existing counter of the same name, is invalid and tests false.
+ * Handles are only meaningful for the PFPObject that issued them.
+ */
+#ifndef CORE_COUNTERHANDLE_H_
+#define CORE_COUNTERHANDLE_H_
+
+#include <cstddef>
+
+namespace pfp {
+namespace core {
+
+class CounterHandle {
+ public:
+  CounterHandle() : slot_(invalid_slot) {
+  }
+
+  explicit operator bool() const {
+    return slot_ != invalid_slot;
+  }
+
+  bool operator==(const CounterHandle& other) const {
+    return slot_ == other.slot_;
+  }
+
+  bool operator!=(const CounterHandle& other) const {
+    return slot_ != other.slot_;
+  }
+
+ private:
+  friend class PFPObject;
+
+  explicit CounterHandle(std::size_t slot) : slot_(slot) {
+  }
+
+  static const std::size_t invalid_slot = ~static_cast<std::size_t>(0);
+  std::size_t slot_;  /*!< Index in the owner's counter storage */
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_COUNTERHANDLE_H_
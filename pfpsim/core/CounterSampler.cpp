@@ -0,0 +1,193 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "CounterSampler.h"
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "PFPContext.h"
+#include "PFPObject.h"
+#include "StringUtils.h"
+
+namespace pfp {
+namespace core {
+
+namespace {
+const char column_magic[8] = {'P', 'F', 'P', 'C', 'O', 'L', 'S', '1'};
+const uint32_t column_format_version = 1;
+
+template <typename T>
+void write_raw(std::ofstream& out, const T* values, std::size_t count) {
+  out.write(reinterpret_cast<const char*>(values), sizeof(T) * count);
+}
+}  // namespace
+
+CounterSampler::CounterSampler(PFPObject* root, const sc_time& interval,
+      const std::string& name, std::size_t rows_per_group,
+      const std::string& directory)
+  : root_(root), interval_(interval),
+    rows_per_group_(rows_per_group ? rows_per_group : 1),
+    started_(false), closed_(false), samples_(0), last_sample_time_(0) {
+  if (interval_ <= SC_ZERO_TIME) {
+    throw std::invalid_argument("CounterSampler interval must be positive");
+  }
+  prefix_ = join_path(directory.empty() ? OUTPUTDIR : directory, name);
+  alive_ = std::make_shared<bool>(true);
+  sc_spawn(sc_bind(&CounterSampler::run, this, alive_, interval_),
+        sc_gen_unique_name("counter_sampler"));
+  end_of_simulation_handle_ = PFPContext::get_current_context()
+        .at_end_of_simulation([this]() {
+          const double now = sc_time_stamp().to_default_time_units();
+          if (samples_ == 0 || now > last_sample_time_) {
+            sample(now);
+          }
+          close();
+        });
+}
+
+CounterSampler::~CounterSampler() {
+  *alive_ = false;
+  PFPContext::get_current_context().cancel_end_of_simulation(
+        end_of_simulation_handle_);
+  close();
+}
+
+void CounterSampler::run(CounterSampler* sampler,
+      std::shared_ptr<bool> alive, sc_time interval) {
+  while (*alive) {
+    sampler->sample(sc_time_stamp().to_default_time_units());
+    wait(interval);
+  }
+}
+
+void CounterSampler::sample(double sim_time) {
+  if (closed_) {
+    return;
+  }
+  if (!started_) {
+    discover(root_);
+    write_header();
+    group_values_.resize(columns_.size());
+    started_ = true;
+  }
+  last_sample_time_ = sim_time;
+  csv_ << sim_time;
+  group_times_.push_back(sim_time);
+  for (std::size_t i = 0; i < columns_.size(); ++i) {
+    const Column& column = columns_[i];
+    const uint64_t value = column.module->has_counter(column.counter)
+          ? column.module->counter_value(column.counter) : 0;
+    csv_ << "," << value;
+    group_values_[i].push_back(value);
+  }
+  csv_ << "\n";
+  ++samples_;
+  if (group_times_.size() >= rows_per_group_) {
+    flush_group();
+  }
+}
+
+void CounterSampler::close() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  if (!started_) {
+    return;
+  }
+  flush_group();
+  csv_.close();
+  binary_.close();
+}
+
+void CounterSampler::discover(PFPObject* module) {
+  const std::string& module_name = module->fully_qualified_module_name()
+        .empty() ? module->module_name()
+        : module->fully_qualified_module_name();
+  for (auto& counter_name : module->counter_names()) {
+    Column column;
+    column.module = module;
+    column.counter = module->counter_handle(counter_name);
+    columns_.push_back(column);
+    column_names_.push_back(module_name + "." + counter_name);
+  }
+  for (auto& child : module->GetChildModules()) {
+    discover(child.second);
+  }
+}
+
+void CounterSampler::write_header() {
+  csv_.open(prefix_ + ".csv");
+  binary_.open(prefix_ + ".pfpcol", std::ios::binary);
+  if (!csv_ || !binary_) {
+    throw std::runtime_error("CounterSampler: cannot create " + prefix_
+          + ".csv/.pfpcol");
+  }
+  // Fixed notation: the default six significant digits would round the
+  // sample times of long runs (1234567 becomes 1.23457e+06)
+  csv_ << std::fixed << std::setprecision(6);
+  csv_ << "time";
+  for (auto& name : column_names_) {
+    csv_ << "," << name;
+  }
+  csv_ << "\n";
+
+  const uint32_t header[2] = {column_format_version,
+        static_cast<uint32_t>(column_names_.size())};
+  binary_.write(column_magic, sizeof(column_magic));
+  write_raw(binary_, header, 2);
+  for (auto& name : column_names_) {
+    const uint32_t length = static_cast<uint32_t>(name.size());
+    write_raw(binary_, &length, 1);
+    binary_.write(name.data(), name.size());
+  }
+}
+
+void CounterSampler::flush_group() {
+  if (group_times_.empty()) {
+    return;
+  }
+  const uint32_t group_header[2] = {
+        static_cast<uint32_t>(group_times_.size()), 0};
+  write_raw(binary_, group_header, 2);
+  write_raw(binary_, group_times_.data(), group_times_.size());
+  for (auto& values : group_values_) {
+    write_raw(binary_, values.data(), values.size());
+    values.clear();
+  }
+  group_times_.clear();
+  binary_.flush();
+  csv_.flush();
+}
+
+};  // namespace core
+};  // namespace pfp
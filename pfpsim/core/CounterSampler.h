@@ -0,0 +1,145 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class CounterSampler
+ * Writes a time series of every counter in a PFPObject hierarchy.
+ * Every interval of simulation time a SystemC process reads the current
+ * value of all counters through their CounterHandles and appends one row;
+ * nothing is done when a counter changes, so the cost does not depend on
+ * how often counters are incremented. The set of counters (the columns) is
+ * fixed by the first sample, taken when the simulation starts; counters
+ * removed later read as 0.
+ *
+ * Two files are written to OUTPUTDIR:
+ *  - <name>.csv: a header "time,<module>.<counter>,..." and one row per
+ *    sample.
+ *  - <name>.pfpcol: the same table in a columnar binary layout. A header
+ *    of the magic "PFPCOLS1", a uint32 version and a uint32 column count,
+ *    then each column name as a uint32 length followed by its bytes. Rows
+ *    follow in groups of up to rows_per_group: a uint32 row count and a
+ *    uint32 0, the sample times as doubles, then the column of each
+ *    counter as uint64 values. Fields are in host byte order.
+ * The files are completed at the end of the simulation, with a last sample.
+ *
+ *   CounterSampler sampler(top, sc_time(1, SC_US));
+ */
+#ifndef CORE_COUNTERSAMPLER_H_
+#define CORE_COUNTERSAMPLER_H_
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "systemc.h"  // NOLINT(build/include)
+#include "CounterHandle.h"
+
+namespace pfp {
+namespace core {
+
+class PFPObject;
+
+class CounterSampler {
+ public:
+  /**
+   * Construct a CounterSampler and spawn its sampling process
+   * @param root            Top of the hierarchy to sample
+   * @param interval        Simulation time between two samples
+   * @param name            Base name of the output files
+   * @param rows_per_group  Rows buffered per group of the binary file
+   * @param directory       Directory of the files; OUTPUTDIR when empty
+   */
+  CounterSampler(PFPObject* root, const sc_time& interval,
+        const std::string& name = "counters",
+        std::size_t rows_per_group = 1024,
+        const std::string& directory = "");
+  ~CounterSampler();
+
+  /**
+   * Append the current value of every counter
+   * @param sim_time  Simulation time of the sample
+   */
+  void sample(double sim_time);
+
+  /**
+   * Write the buffered rows and close the files; later samples are ignored
+   */
+  void close();
+
+  //! Names of the sampled counters, as <module>.<counter>
+  const std::vector<std::string>& columns() const {
+    return column_names_;
+  }
+
+  //! Number of samples taken
+  std::size_t samples() const {
+    return samples_;
+  }
+
+ private:
+  struct Column {
+    PFPObject* module;
+    CounterHandle counter;
+  };
+
+  //! Sampling process; it outlives the sampler, so it only touches the
+  //! sampler while *alive is true
+  static void run(CounterSampler* sampler, std::shared_ptr<bool> alive,
+        sc_time interval);
+  void discover(PFPObject* module);
+  void write_header();
+  void flush_group();
+
+  PFPObject* root_;
+  const sc_time interval_;
+  const std::size_t rows_per_group_;
+  std::string prefix_;      /*!< Path of the output files without suffix */
+  std::vector<Column> columns_;
+  std::vector<std::string> column_names_;
+  std::ofstream csv_;
+  std::ofstream binary_;
+  //! Current row group, column by column
+  std::vector<double> group_times_;
+  std::vector<std::vector<uint64_t>> group_values_;
+  bool started_;
+  bool closed_;
+  std::size_t samples_;
+  double last_sample_time_;
+  std::size_t end_of_simulation_handle_;
+  //! Shared with run(); cleared when the sampler is destroyed
+  std::shared_ptr<bool> alive_;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_COUNTERSAMPLER_H_
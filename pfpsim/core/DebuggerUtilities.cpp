@@ -37,8 +37,8 @@ DebuggerUtilities::DebuggerUtilities() {
 
 void DebuggerUtilities::notify_observers(pfp::core::PFPObject* object) {
   while (1) {
-    auto func = object->events_.pop();
-    func();
+    auto event = object->events_.pop();
+    pfp::core::PFPObject::dispatch(event);
   }
 }
 
@@ -0,0 +1,134 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "DropPolicy.h"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace pfp {
+namespace core {
+
+namespace {
+const std::string tail_drop_reason = "tail drop";
+const std::string head_drop_reason = "head drop";
+const std::string red_early_drop_reason = "RED early drop";
+const std::string red_forced_drop_reason = "RED forced drop";
+const std::string shared_buffer_drop_reason = "shared buffer threshold";
+}  // namespace
+
+DropPolicy::Decision TailDrop::admit(std::size_t occupancy,
+      std::size_t capacity, std::size_t drop_class) {
+  if (occupancy < capacity) {
+    return admit_item();
+  }
+  return Decision{Verdict::DropIncoming, &tail_drop_reason};
+}
+
+DropPolicy::Decision HeadDrop::admit(std::size_t occupancy,
+      std::size_t capacity, std::size_t drop_class) {
+  if (occupancy < capacity) {
+    return admit_item();
+  }
+  return Decision{Verdict::DropHead, &head_drop_reason};
+}
+
+WeightedRED::WeightedRED(std::vector<Profile> profiles, double weight,
+      unsigned seed)
+      : profiles_(profiles), weight_(weight), average_(0),
+      since_last_drop_(0), generator_(seed), uniform_(0.0, 1.0) {
+  if (profiles_.empty()) {
+    throw std::invalid_argument("WRED needs at least one drop profile");
+  }
+}
+
+DropPolicy::Decision WeightedRED::admit(std::size_t occupancy,
+      std::size_t capacity, std::size_t drop_class) {
+  average_ += weight_ * (occupancy - average_);
+  if (occupancy >= capacity) {
+    since_last_drop_ = 0;
+    return Decision{Verdict::DropIncoming, &tail_drop_reason};
+  }
+
+  const Profile& profile
+        = profiles_[std::min(drop_class, profiles_.size() - 1)];
+  if (average_ < profile.min_threshold) {
+    since_last_drop_ = 0;
+    return admit_item();
+  }
+  if (average_ >= profile.max_threshold) {
+    since_last_drop_ = 0;
+    return Decision{Verdict::DropIncoming, &red_forced_drop_reason};
+  }
+
+  // Spread drops out evenly: the probability grows with the number of
+  // arrivals since the last drop (Floyd & Jacobson, 1993)
+  const double base = profile.max_probability
+        * (average_ - profile.min_threshold)
+        / (profile.max_threshold - profile.min_threshold);
+  const double scaled = since_last_drop_ * base;
+  const double probability = scaled < 1 ? base / (1 - scaled) : 1;
+  ++since_last_drop_;
+  if (uniform_(generator_) < probability) {
+    since_last_drop_ = 0;
+    return Decision{Verdict::DropIncoming, &red_early_drop_reason};
+  }
+  return admit_item();
+}
+
+DynamicThreshold::DynamicThreshold(std::shared_ptr<SharedBuffer> buffer,
+      double alpha)
+      : buffer_(buffer), alpha_(alpha) {
+}
+
+DropPolicy::Decision DynamicThreshold::admit(std::size_t occupancy,
+      std::size_t capacity, std::size_t drop_class) {
+  const double threshold = alpha_ * (buffer_->size - buffer_->used);
+  if (occupancy >= capacity) {
+    return Decision{Verdict::DropIncoming, &tail_drop_reason};
+  }
+  if (buffer_->used >= buffer_->size || occupancy >= threshold) {
+    return Decision{Verdict::DropIncoming, &shared_buffer_drop_reason};
+  }
+  ++buffer_->used;
+  return admit_item();
+}
+
+void DynamicThreshold::released() {
+  if (buffer_->used > 0) {
+    --buffer_->used;
+  }
+}
+
+};  // namespace core
+};  // namespace pfp
@@ -0,0 +1,209 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @file DropPolicy.h
+ * Admission policies for bounded queues.
+ *
+ * An LMTQueue with a DropPolicy never blocks its producers: every arriving
+ * item is either admitted or dropped, and dropped items are reported through
+ * PFPObject::drop_data with the reason given by the policy.
+ *
+ *   LMTQueue<std::shared_ptr<Packet>, 128> q;
+ *   q.set_drop_policy(std::make_shared<RandomEarlyDetection>(32, 96, 0.1),
+ *                     this);
+ */
+#ifndef CORE_DROPPOLICY_H_
+#define CORE_DROPPOLICY_H_
+
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "TrType.h"
+
+namespace pfp {
+namespace core {
+
+class DropPolicy {
+ public:
+  enum class Verdict {
+    Admit,          /*!< Queue the arriving item */
+    DropIncoming,   /*!< Drop the arriving item */
+    DropHead        /*!< Drop the item at the head, then queue the arrival */
+  };
+
+  struct Decision {
+    Verdict verdict;
+    const std::string* reason;  /*!< Drop reason, null when admitted */
+  };
+
+  virtual ~DropPolicy() = default;
+
+  /**
+   * Decide what to do with an arriving item
+   * @param occupancy   Number of items in the queue
+   * @param capacity    Maximum number of items in the queue
+   * @param drop_class  Drop precedence class of the item (used by WRED)
+   * @return            Verdict and drop reason
+   */
+  virtual Decision admit(std::size_t occupancy, std::size_t capacity,
+        std::size_t drop_class) = 0;
+
+  /**
+   * Called whenever an item leaves the queue, popped or dropped from the head
+   */
+  virtual void released() {}
+
+ protected:
+  static Decision admit_item() {
+    return Decision{Verdict::Admit, nullptr};
+  }
+};
+
+/**
+ * Drop arrivals once the queue is full
+ */
+class TailDrop : public DropPolicy {
+ public:
+  Decision admit(std::size_t occupancy, std::size_t capacity,
+        std::size_t drop_class) override;
+};
+
+/**
+ * Drop the oldest queued item to make room for an arrival once the queue is
+ * full
+ */
+class HeadDrop : public DropPolicy {
+ public:
+  Decision admit(std::size_t occupancy, std::size_t capacity,
+        std::size_t drop_class) override;
+};
+
+/**
+ * Weighted random early detection. Each drop class has its own thresholds on
+ * the exponentially weighted average queue length; between min_threshold
+ * and max_threshold arrivals are dropped with a probability rising linearly
+ * to max_probability, above max_threshold they are always dropped.
+ */
+class WeightedRED : public DropPolicy {
+ public:
+  struct Profile {
+    double min_threshold;
+    double max_threshold;
+    double max_probability;
+  };
+
+  /**
+   * @param profiles  Thresholds per drop class; classes beyond the last
+   *                  profile use the last profile
+   * @param weight    Weight of the current queue length in the average
+   * @param seed      Seed of the drop decision generator
+   */
+  explicit WeightedRED(std::vector<Profile> profiles, double weight = 0.002,
+        unsigned seed = 1);
+
+  Decision admit(std::size_t occupancy, std::size_t capacity,
+        std::size_t drop_class) override;
+
+  double average_queue_length() const { return average_; }
+
+ private:
+  std::vector<Profile> profiles_;
+  double weight_;
+  double average_;
+  std::size_t since_last_drop_;  /*!< Arrivals since the last early drop */
+  std::minstd_rand generator_;
+  std::uniform_real_distribution<double> uniform_;
+};
+
+/**
+ * Random early detection with a single drop profile
+ */
+class RandomEarlyDetection : public WeightedRED {
+ public:
+  RandomEarlyDetection(double min_threshold, double max_threshold,
+        double max_probability, double weight = 0.002, unsigned seed = 1)
+  : WeightedRED({{min_threshold, max_threshold, max_probability}},
+          weight, seed) {
+  }
+};
+
+/**
+ * Buffer memory shared by several queues using DynamicThreshold
+ */
+struct SharedBuffer {
+  explicit SharedBuffer(std::size_t size) : size(size), used(0) {}
+  const std::size_t size;  /*!< Items the shared memory can hold */
+  std::size_t used;        /*!< Items currently held over all queues */
+};
+
+/**
+ * Dynamic threshold admission for queues sharing one buffer: a queue may
+ * grow up to alpha times the currently unused shared buffer
+ */
+class DynamicThreshold : public DropPolicy {
+ public:
+  DynamicThreshold(std::shared_ptr<SharedBuffer> buffer, double alpha = 1.0);
+
+  Decision admit(std::size_t occupancy, std::size_t capacity,
+        std::size_t drop_class) override;
+  void released() override;
+
+ private:
+  std::shared_ptr<SharedBuffer> buffer_;
+  double alpha_;
+};
+
+/**
+ * Report a dropped item through owner->drop_data when it is a TrType
+ */
+template <typename Owner, typename U>
+typename std::enable_if<std::is_base_of<TrType, U>::value>::type
+report_drop(Owner* owner, const std::shared_ptr<U>& item,
+      const std::string& reason) {
+  owner->drop_data(item, reason);
+}
+
+/**
+ * Items that are not TrTypes cannot be seen by observers, they are only
+ * counted by the queue
+ */
+template <typename Owner, typename Item>
+void report_drop(Owner* owner, const Item& item, const std::string& reason) {
+}
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_DROPPOLICY_H_
@@ -0,0 +1,120 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "EventObserver.h"
+#include <string>
+#include <utility>
+
+namespace pfp {
+namespace core {
+
+void EventObserver::post(ObserverEvent::Kind kind, const std::string& module,
+      const std::string& name, std::size_t value, std::size_t packet,
+      double simulation_time, std::shared_ptr<TrType> data) {
+  NameTable& names = NameTable::get();
+  observe(ObserverEvent{kind, ObserverEvent::Delivery::All,
+        names.intern(module), names.intern(name), value, packet,
+        simulation_time, nullptr, std::move(data)});
+}
+
+void EventObserver::counter_added(const std::string& module_name,
+      const std::string& counter_name, double simulation_time) {
+  post(ObserverEvent::Kind::CounterAdded, module_name, counter_name, 0, 0,
+        simulation_time);
+}
+
+void EventObserver::counter_removed(const std::string& module_name,
+      const std::string& counter_name, double simulation_time) {
+  post(ObserverEvent::Kind::CounterRemoved, module_name, counter_name, 0, 0,
+        simulation_time);
+}
+
+void EventObserver::counter_updated(const std::string& module_name,
+      const std::string& counter_name, std::size_t new_value,
+      double simulation_time) {
+  post(ObserverEvent::Kind::CounterUpdated, module_name, counter_name,
+        new_value, 0, simulation_time);
+}
+
+void EventObserver::data_written(const std::string& from_module,
+      const std::shared_ptr<TrType> data, double simulation_time) {
+  post(ObserverEvent::Kind::DataWritten, from_module, "", 0, 0,
+        simulation_time, data);
+}
+
+void EventObserver::data_read(const std::string& to_module,
+      const std::shared_ptr<TrType> data, double simulation_time) {
+  post(ObserverEvent::Kind::DataRead, to_module, "", 0, 0, simulation_time,
+        data);
+}
+
+void EventObserver::data_dropped(const std::string& in_module,
+      const std::shared_ptr<TrType> data, const std::string& drop_reason,
+      double simulation_time) {
+  post(ObserverEvent::Kind::DataDropped, in_module, drop_reason, 0, 0,
+        simulation_time, data);
+}
+
+void EventObserver::thread_begin(const std::string& teu_mod,
+      const std::string& tec_mod, std::size_t thread_id,
+      std::size_t packet_id, double simulation_time) {
+  post(ObserverEvent::Kind::ThreadBegin, teu_mod, tec_mod, thread_id,
+        packet_id, simulation_time);
+}
+
+void EventObserver::thread_end(const std::string& teu_mod,
+      const std::string& tec_mod, std::size_t thread_id,
+      std::size_t packet_id, double simulation_time) {
+  post(ObserverEvent::Kind::ThreadEnd, teu_mod, tec_mod, thread_id,
+        packet_id, simulation_time);
+}
+
+void EventObserver::thread_idle(const std::string& teu_mod,
+      const std::string& tec_mod, std::size_t thread_id,
+      std::size_t packet_id, double simulation_time) {
+  post(ObserverEvent::Kind::ThreadIdle, teu_mod, tec_mod, thread_id,
+        packet_id, simulation_time);
+}
+
+void EventObserver::core_busy(const std::string& teu_mod,
+      const std::string& tec_mod, double simulation_time) {
+  post(ObserverEvent::Kind::CoreBusy, teu_mod, tec_mod, 0, 0,
+        simulation_time);
+}
+
+void EventObserver::core_idle(const std::string& teu_mod,
+      const std::string& tec_mod, double simulation_time) {
+  post(ObserverEvent::Kind::CoreIdle, teu_mod, tec_mod, 0, 0,
+        simulation_time);
+}
+
+};  // namespace core
+};  // namespace pfp
@@ -0,0 +1,96 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class EventObserver
+ * Base for observers that work on ObserverEvent records rather than on the
+ * string callbacks of PFPObserver.
+ * Subclasses implement observe(); the string callbacks, which some paths
+ * still call directly (e.g. notify_counter_added), are turned into events
+ * and routed through observe() as well.
+ */
+#ifndef CORE_EVENTOBSERVER_H_
+#define CORE_EVENTOBSERVER_H_
+
+#include <memory>
+#include <string>
+#include "ObserverEvent.h"
+#include "PFPObserver.h"
+
+namespace pfp {
+namespace core {
+
+class EventObserver : public PFPObserver {
+ public:
+  /**
+   * Handle one event
+   * @param event      Event to handle
+   */
+  void observe(const ObserverEvent& event) override = 0;
+
+  void counter_added(const std::string& module_name,
+        const std::string& counter_name, double simulation_time) override;
+  void counter_removed(const std::string& module_name,
+        const std::string& counter_name, double simulation_time) override;
+  void counter_updated(const std::string& module_name,
+        const std::string& counter_name, std::size_t new_value,
+        double simulation_time) override;
+  void data_written(const std::string& from_module,
+        const std::shared_ptr<TrType> data, double simulation_time) override;
+  void data_read(const std::string& to_module,
+        const std::shared_ptr<TrType> data, double simulation_time) override;
+  void data_dropped(const std::string& in_module,
+        const std::shared_ptr<TrType> data, const std::string& drop_reason,
+        double simulation_time) override;
+  void thread_begin(const std::string& teu_mod, const std::string& tec_mod,
+        std::size_t thread_id, std::size_t packet_id,
+        double simulation_time) override;
+  void thread_end(const std::string& teu_mod, const std::string& tec_mod,
+        std::size_t thread_id, std::size_t packet_id,
+        double simulation_time) override;
+  void thread_idle(const std::string& teu_mod, const std::string& tec_mod,
+        std::size_t thread_id, std::size_t packet_id,
+        double simulation_time) override;
+  void core_busy(const std::string& teu_mod, const std::string& tec_mod,
+        double simulation_time) override;
+  void core_idle(const std::string& teu_mod, const std::string& tec_mod,
+        double simulation_time) override;
+
+ private:
+  void post(ObserverEvent::Kind kind, const std::string& module,
+        const std::string& name, std::size_t value, std::size_t packet,
+        double simulation_time, std::shared_ptr<TrType> data = nullptr);
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_EVENTOBSERVER_H_
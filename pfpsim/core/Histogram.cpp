@@ -0,0 +1,133 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "Histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace pfp {
+namespace core {
+
+Histogram::Histogram(unsigned precision)
+      : precision_(checked_precision(precision)),
+      sub_bucket_count_(uint64_t(1) << precision_),
+      half_sub_bucket_count_(uint64_t(1) << (precision_ - 1)),
+      total_count_(0), total_sum_(0),
+      min_(std::numeric_limits<uint64_t>::max()), max_(0) {
+  // One linear range below 2^precision, then half_sub_bucket_count_
+  // sub-buckets for each of the remaining powers of two up to 2^64.
+  counts_.assign(sub_bucket_count_
+        + (64 - precision_) * half_sub_bucket_count_, 0);
+}
+
+unsigned Histogram::checked_precision(unsigned precision) {
+  if (precision < 1 || precision > 16) {
+    throw std::invalid_argument("Histogram precision must be in [1, 16]");
+  }
+  return precision;
+}
+
+void Histogram::merge(const Histogram& other) {
+  if (other.precision_ != precision_) {
+    throw std::invalid_argument("Cannot merge histograms of "
+          "different precision");
+  }
+  for (std::size_t i = 0; i < counts_.size(); ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  total_count_ += other.total_count_;
+  total_sum_ += other.total_sum_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+void Histogram::reset() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  total_count_ = 0;
+  total_sum_ = 0;
+  min_ = std::numeric_limits<uint64_t>::max();
+  max_ = 0;
+}
+
+double Histogram::mean() const {
+  return total_count_ ? total_sum_ / total_count_ : 0;
+}
+
+uint64_t Histogram::bucket_lower_bound(std::size_t index) const {
+  if (index < sub_bucket_count_) {
+    return index;
+  }
+  const uint64_t shift = (index - sub_bucket_count_) / half_sub_bucket_count_
+        + 1;
+  const uint64_t sub = (index - sub_bucket_count_) % half_sub_bucket_count_
+        + half_sub_bucket_count_;
+  return sub << shift;
+}
+
+uint64_t Histogram::bucket_upper_bound(std::size_t index) const {
+  if (index + 1 == counts_.size()) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  return bucket_lower_bound(index + 1) - 1;
+}
+
+uint64_t Histogram::value_at_percentile(double percentile) const {
+  if (total_count_ == 0) {
+    return 0;
+  }
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  uint64_t target = static_cast<uint64_t>(
+        std::ceil(percentile / 100.0 * total_count_));
+  target = std::max<uint64_t>(target, 1);
+  uint64_t seen = 0;
+  for (std::size_t i = 0; i < counts_.size(); ++i) {
+    seen += counts_[i];
+    if (seen >= target) {
+      return std::min(bucket_upper_bound(i), max_);
+    }
+  }
+  return max_;
+}
+
+void Histogram::summary(std::ostream& os) const {
+  os << "count=" << count()
+     << " mean=" << mean()
+     << " min=" << min()
+     << " p50=" << value_at_percentile(50)
+     << " p90=" << value_at_percentile(90)
+     << " p99=" << value_at_percentile(99)
+     << " p999=" << value_at_percentile(99.9)
+     << " max=" << max();
+}
+
+};  // namespace core
+};  // namespace pfp
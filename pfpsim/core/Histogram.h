@@ -0,0 +1,156 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class Histogram
+ * Log-linear (HDR style) histogram of non-negative integer values.
+ * Values below 2^precision each get their own bucket; above that every
+ * power of two is split into 2^(precision-1) linear sub-buckets, so the
+ * relative error of any reported value is bounded by 2^-(precision-1).
+ * All buckets are allocated by the constructor; record() is constant time
+ * and never allocates.
+ */
+#ifndef CORE_HISTOGRAM_H_
+#define CORE_HISTOGRAM_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace pfp {
+namespace core {
+
+class Histogram {
+ public:
+  /**
+   * Construct a Histogram
+   * @param precision  Number of significant bits kept per value (1-16)
+   */
+  explicit Histogram(unsigned precision = 6);
+
+  /**
+   * Record a value
+   * @param value  Value to record
+   * @param count  Number of occurrences of the value
+   */
+  void record(uint64_t value, uint64_t count = 1) {
+    counts_[bucket_index(value)] += count;
+    total_count_ += count;
+    total_sum_ += static_cast<double>(value) * count;
+    if (value < min_) {
+      min_ = value;
+    }
+    if (value > max_) {
+      max_ = value;
+    }
+  }
+
+  /**
+   * Add all values recorded in other to this Histogram
+   * @param other  Histogram with the same precision
+   */
+  void merge(const Histogram& other);
+
+  /**
+   * Forget all recorded values
+   */
+  void reset();
+
+  uint64_t count() const { return total_count_; }
+  uint64_t min() const { return total_count_ ? min_ : 0; }
+  uint64_t max() const { return max_; }
+  double mean() const;
+  unsigned precision() const { return precision_; }
+
+  /**
+   * Get the value below which the given percentage of recorded values fall
+   * @param percentile  Percentile in [0, 100]
+   * @return            Upper bound of the bucket holding that percentile
+   */
+  uint64_t value_at_percentile(double percentile) const;
+
+  /**
+   * Number of buckets in the Histogram
+   */
+  std::size_t bucket_count() const { return counts_.size(); }
+  /**
+   * Number of values recorded in a bucket
+   */
+  uint64_t bucket_value_count(std::size_t index) const {
+    return counts_[index];
+  }
+  /**
+   * Smallest value that falls in a bucket
+   */
+  uint64_t bucket_lower_bound(std::size_t index) const;
+  /**
+   * Largest value that falls in a bucket
+   */
+  uint64_t bucket_upper_bound(std::size_t index) const;
+
+  /**
+   * Print count, mean, min, max and the usual percentiles on one line
+   * @param os  Stream to write to
+   */
+  void summary(std::ostream& os) const;
+
+ private:
+  //! precision, or std::invalid_argument if it is outside [1, 16]
+  static unsigned checked_precision(unsigned precision);
+
+  std::size_t bucket_index(uint64_t value) const {
+    if (value < sub_bucket_count_) {
+      return static_cast<std::size_t>(value);
+    }
+    // Position of the highest set bit selects the power-of-two range, the
+    // next (precision - 1) bits select the linear sub-bucket within it.
+    const unsigned msb = 63 - __builtin_clzll(value);
+    const unsigned shift = msb - precision_ + 1;
+    return sub_bucket_count_ + (shift - 1) * half_sub_bucket_count_
+          + ((value >> shift) - half_sub_bucket_count_);
+  }
+
+  unsigned precision_;
+  uint64_t sub_bucket_count_;       /*!< 2^precision */
+  uint64_t half_sub_bucket_count_;  /*!< 2^(precision - 1) */
+  std::vector<uint64_t> counts_;    /*!< Per-bucket value counts */
+  uint64_t total_count_;
+  double total_sum_;
+  uint64_t min_;
+  uint64_t max_;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_HISTOGRAM_H_
@@ -38,42 +38,56 @@
  * @class LMTQueue
  * A size-limited multiple-producer, multiple-consumer, thread-safe queue implemented using SystemC primitives
  * The LMTQueue is used as the input buffer in the NPU modules
+ * The optional Stats parameter selects an instrumentation policy (QueueStats.h)
  */
 #ifndef CORE_LMTQUEUE_H_
 #define CORE_LMTQUEUE_H_
 
-#include <queue>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
 #include "systemc.h"
+#include "DropPolicy.h"
+#include "QueueStats.h"
+#include "RingBuffer.h"
 
-template <typename T, size_t N>
+template <typename T, size_t N,
+          typename Stats = pfp::core::NoQueueStats>
 class LMTQueue {
+  static_assert(N > 0, "LMTQueue capacity must be non-zero");
+
  public:
   /**
    * Construct a LMTQueue
+   * The storage for all N items is allocated here, push and pop never
+   * allocate afterwards.
    */
   LMTQueue()
-  : queue_(), mutex_(sc_gen_unique_name("mutex_")),
-  cond_not_empty_(sc_gen_unique_name("cond_not_empty_")), slots_(0) {
+  : queue_(N), mutex_(sc_gen_unique_name("mutex_")),
+  cond_not_empty_(sc_gen_unique_name("cond_not_empty_")),
+  cond_not_full_(sc_gen_unique_name("cond_not_full_")), dropped_(0) {
   }
   /**
-   * Pop the top element from the LMTQueue and return a copy
-   * @return  Copy of the top element
+   * Pop the top element from the LMTQueue and return it
+   * @return  The top element, moved out of the queue
    */
   T pop() {
     while (queue_.empty()) {
       wait(cond_not_empty_);
     }
     mutex_.lock();
-    auto item = queue_.front();
-    queue_.pop();
-    slots_--;
+    T item = queue_.pop_front();
+    stats_.on_pop(queue_.size());
+    released();
     mutex_.unlock();
     cond_not_full_.notify();
     return item;
   }
 
   /**
-   * Pop the top element from the LMTQueue and copy it into the output argument
+   * Pop the top element from the LMTQueue and move it into the output argument
    * @param  Output argument
    */
   void pop(T& item) {
@@ -81,26 +95,109 @@ class LMTQueue {
       wait(cond_not_empty_);
     }
     mutex_.lock();
-    item = queue_.front();
-    queue_.pop();
-    slots_--;
+    queue_.pop_front(item);
+    stats_.on_pop(queue_.size());
+    released();
     mutex_.unlock();
     cond_not_full_.notify();
   }
 
   /**
-   * Push an item onto the LMTQueue
-   * @param  Item to push
+   * Pop the top element if there is one, without blocking
+   * @param  Output argument
+   * @return True if an element was popped
    */
-  void push(const T& item) {
-    while (this->full()) {
-      wait(cond_not_full_);
+  bool try_pop(T& item) {
+    if (queue_.empty()) {
+      return false;
     }
     mutex_.lock();
-    queue_.push(item);
-    slots_++;
+    queue_.pop_front(item);
+    stats_.on_pop(queue_.size());
+    released();
     mutex_.unlock();
-    cond_not_empty_.notify();
+    cond_not_full_.notify();
+    return true;
+  }
+
+  /**
+   * Pop the top element, waiting at most timeout for one to arrive
+   * @param  Output argument
+   * @param  Maximum simulation time to wait
+   * @return True if an element was popped, false on timeout
+   */
+  bool pop(T& item, const sc_time& timeout) {
+    const sc_time deadline = sc_time_stamp() + timeout;
+    while (queue_.empty()) {
+      const sc_time now = sc_time_stamp();
+      if (now >= deadline) {
+        return false;
+      }
+      wait(deadline - now, cond_not_empty_);
+    }
+    return try_pop(item);
+  }
+
+  /**
+   * Wait until the LMTQueue is not empty, then move up to max_items elements
+   * into out under a single lock acquisition and a single notification
+   * @param  Output iterator receiving the elements
+   * @param  Maximum number of elements to pop
+   * @return Number of elements popped
+   */
+  template <typename OutputIt>
+  std::size_t pop_up_to(OutputIt out, std::size_t max_items) {
+    while (queue_.empty()) {
+      wait(cond_not_empty_);
+    }
+    return take(out, max_items);
+  }
+
+  /**
+   * Move every element currently in the LMTQueue into the back of a
+   * container, without blocking
+   * @param  Container supporting push_back
+   * @return Number of elements moved
+   */
+  template <typename Container>
+  std::size_t drain_into(Container& container) {
+    return take(std::back_inserter(container), queue_.size());
+  }
+
+  /**
+   * Push a range of items onto the LMTQueue. As many items as fit are pushed
+   * under one lock acquisition and one notification; the producer only
+   * blocks when the LMTQueue fills up part way through the range.
+   * @param  Range of items to push
+   */
+  template <typename InputIt>
+  void push_n(InputIt first, InputIt last) {
+    if (drop_policy_) {
+      for (; first != last; ++first) {
+        admit(T(*first));
+      }
+      return;
+    }
+    while (first != last) {
+      while (this->full()) {
+        wait(cond_not_full_);
+      }
+      mutex_.lock();
+      for (; first != last && !this->full(); ++first) {
+        queue_.emplace_back(*first);
+        stats_.on_push(queue_.size());
+      }
+      mutex_.unlock();
+      cond_not_empty_.notify();
+    }
+  }
+
+  /**
+   * Push an item onto the LMTQueue
+   * @param  Item to push
+   */
+  void push(const T& item) {
+    emplace(item);
   }
 
   /**
@@ -108,34 +205,147 @@ class LMTQueue {
    * @param  Item to move
    */
   void push(T&& item) {
+    emplace(std::move(item));
+  }
+
+  /**
+   * Construct an item in place at the back of the LMTQueue
+   * @param  Constructor arguments for the item
+   */
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    if (drop_policy_) {
+      admit(T(std::forward<Args>(args)...));
+      return;
+    }
     while (this->full()) {
       wait(cond_not_full_);
     }
     mutex_.lock();
-    queue_.push(std::move(item));
-    slots_++;
+    queue_.emplace_back(std::forward<Args>(args)...);
+    stats_.on_push(queue_.size());
     mutex_.unlock();
     cond_not_empty_.notify();
   }
 
   size_t available() const {
-    return N - slots_;
+    return N - queue_.size();
   }
 
   bool full() const {
-    return (slots_ == N);
+    return (queue_.size() == N);
   }
 
   bool empty() const {
     return queue_.empty();
   }
 
+  /**
+   * Replace the blocking behaviour of push with an admission policy (see
+   * DropPolicy.h). Producers never wait once a policy is set; rejected items
+   * are counted and, when they are TrTypes, reported through
+   * owner->drop_data with the policy's reason.
+   * @param policy    Admission policy, or nullptr to restore blocking pushes
+   * @param owner     Module reporting the drops (may be null)
+   * @param classify  Drop class of an item, for WeightedRED (default: 0)
+   */
+  template <typename Owner>
+  void set_drop_policy(std::shared_ptr<pfp::core::DropPolicy> policy,
+        Owner* owner,
+        std::function<std::size_t(const T&)> classify = nullptr) {
+    drop_policy_ = policy;
+    classify_ = classify;
+    if (owner) {
+      report_drop_ = [owner](const T& item, const std::string& reason) {
+        pfp::core::report_drop(owner, item, reason);
+      };
+    } else {
+      report_drop_ = nullptr;
+    }
+  }
+
+  /**
+   * Number of items rejected by the drop policy
+   */
+  std::size_t dropped() const {
+    return dropped_;
+  }
+
+  /**
+   * Access the instrumentation policy (see QueueStats.h)
+   * @return  Statistics recorded for this queue
+   */
+  const Stats& stats() const {
+    return stats_;
+  }
+
+  Stats& stats() {
+    return stats_;
+  }
+
  private:
-  std::queue<T> queue_;            /*!< Internal queue */
+  void admit(T&& item) {
+    typedef pfp::core::DropPolicy::Verdict Verdict;
+    auto decision = drop_policy_->admit(queue_.size(), N,
+          classify_ ? classify_(item) : 0);
+    if (decision.verdict == Verdict::DropHead && !queue_.empty()) {
+      mutex_.lock();
+      T head = queue_.pop_front();
+      stats_.on_drop(queue_.size());
+      released();
+      mutex_.unlock();
+      drop(head, *decision.reason);
+    } else if (decision.verdict != Verdict::Admit || this->full()) {
+      drop(item, decision.reason ? *decision.reason : "queue full");
+      return;
+    }
+    mutex_.lock();
+    queue_.emplace_back(std::move(item));
+    stats_.on_push(queue_.size());
+    mutex_.unlock();
+    cond_not_empty_.notify();
+  }
+
+  void drop(const T& item, const std::string& reason) {
+    ++dropped_;
+    if (report_drop_) {
+      report_drop_(item, reason);
+    }
+  }
+
+  void released() {
+    if (drop_policy_) {
+      drop_policy_->released();
+    }
+  }
+
+  template <typename OutputIt>
+  std::size_t take(OutputIt out, std::size_t max_items) {
+    if (queue_.empty()) {
+      return 0;
+    }
+    std::size_t count = 0;
+    mutex_.lock();
+    for (; count < max_items && !queue_.empty(); ++count) {
+      *out++ = queue_.pop_front();
+      stats_.on_pop(queue_.size());
+      released();
+    }
+    mutex_.unlock();
+    cond_not_full_.notify();
+    return count;
+  }
+
+  pfp::core::RingBuffer<T> queue_;  /*!< Internal ring, sized for N items */
   sc_mutex mutex_;              /*!< Guard */
   //! Events to notify when not empty and not full
   sc_event cond_not_empty_, cond_not_full_;
-  size_t slots_;                /*!< Number of queue positions used */
+  Stats stats_;                 /*!< Instrumentation policy */
+  //! Admission policy; when null push blocks while the queue is full
+  std::shared_ptr<pfp::core::DropPolicy> drop_policy_;
+  std::function<std::size_t(const T&)> classify_;
+  std::function<void(const T&, const std::string&)> report_drop_;
+  std::size_t dropped_;         /*!< Items rejected by drop_policy_ */
 };
 
 #endif  // CORE_LMTQUEUE_H_
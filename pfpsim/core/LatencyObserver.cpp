@@ -0,0 +1,168 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "LatencyObserver.h"
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "PFPConfig.h"
+#include "PFPContext.h"
+#include "TrType.h"
+
+namespace pfp {
+namespace core {
+
+LatencyObserver::LatencyObserver(
+      const std::vector<std::string>& egress_modules,
+      std::size_t max_in_flight, std::ostream& out,
+      ObserverEvent::Kind egress_kind)
+  : max_in_flight_(max_in_flight), out_(out), egress_kind_(egress_kind),
+    evicted_(0), dropped_(0) {
+  for (auto& module : egress_modules) {
+    egress_.insert(NameTable::get().intern(module));
+  }
+  end_of_simulation_handle_ = PFPContext::get_current_context()
+        .at_end_of_simulation([this]() { report(out_); });
+}
+
+LatencyObserver::~LatencyObserver() {
+  PFPContext::get_current_context().cancel_end_of_simulation(
+        end_of_simulation_handle_);
+}
+
+void LatencyObserver::observe(const ObserverEvent& event) {
+  if (!event.data) {
+    return;
+  }
+  const std::size_t id = event.data->id();
+  const double now = event.time;
+  auto it = in_flight_.find(id);
+
+  if (event.kind == ObserverEvent::Kind::DataDropped) {
+    if (it != in_flight_.end()) {
+      forget(it);
+      ++dropped_;
+    }
+    return;
+  }
+  if (event.kind != ObserverEvent::Kind::DataWritten
+        && event.kind != ObserverEvent::Kind::DataRead) {
+    return;
+  }
+
+  const bool at_egress = egress_.count(event.module) != 0;
+  if (it == in_flight_.end()) {
+    if (at_egress) {
+      // Sighted only once it is leaving, or already counted as gone
+      return;
+    }
+    if (in_flight_.size() >= max_in_flight_) {
+      evict_oldest();
+    }
+    InFlight packet;
+    packet.ingress = packet.last_module = event.module;
+    packet.first = packet.last = now;
+    packet.arrival = arrival_order_.insert(arrival_order_.end(), id);
+    it = in_flight_.emplace(id, packet).first;
+  } else {
+    InFlight& packet = it->second;
+    hops_[pair_key(packet.last_module, event.module)]
+          .record(PFPConfig::picoseconds(now - packet.last));
+    packet.last_module = event.module;
+    packet.last = now;
+  }
+
+  if (at_egress && event.kind == egress_kind_) {
+    const uint64_t latency =
+          PFPConfig::picoseconds(now - it->second.first);
+    paths_[pair_key(it->second.ingress, event.module)].record(latency);
+    end_to_end_.record(latency);
+    forget(it);
+  }
+}
+
+void LatencyObserver::evict_oldest() {
+  if (arrival_order_.empty()) {
+    return;
+  }
+  forget(in_flight_.find(arrival_order_.front()));
+  ++evicted_;
+}
+
+void LatencyObserver::forget(
+      std::unordered_map<std::size_t, InFlight>::iterator packet) {
+  arrival_order_.erase(packet->second.arrival);
+  in_flight_.erase(packet);
+}
+
+void LatencyObserver::report(std::ostream& os) const {
+  auto& names = NameTable::get();
+  auto print = [&](const std::unordered_map<uint64_t, Histogram>& pairs) {
+    std::map<std::pair<std::string, std::string>, const Histogram*> sorted;
+    for (auto& each : pairs) {
+      sorted.emplace(std::make_pair(
+            names.name(static_cast<NameTable::Id>(each.first >> 32)),
+            names.name(static_cast<NameTable::Id>(each.first))),
+            &each.second);
+    }
+    for (auto& each : sorted) {
+      os << "  " << each.first.first << " -> " << each.first.second << ": ";
+      each.second->summary(os);
+      os << std::endl;
+    }
+  };
+  os << "Latency report (ps):" << std::endl
+     << " end to end: ";
+  end_to_end_.summary(os);
+  os << std::endl
+     << " in flight " << in_flight_.size() << ", dropped " << dropped_
+     << ", evicted " << evicted_ << std::endl
+     << " per path:" << std::endl;
+  print(paths_);
+  os << " per hop:" << std::endl;
+  print(hops_);
+}
+
+const Histogram& LatencyObserver::hop(const std::string& from,
+      const std::string& to) const {
+  auto& names = NameTable::get();
+  const NameTable::Id from_id = names.find(from);
+  const NameTable::Id to_id = names.find(to);
+  if (from_id == NameTable::invalid || to_id == NameTable::invalid) {
+    return empty_;
+  }
+  auto it = hops_.find(pair_key(from_id, to_id));
+  return it == hops_.end() ? empty_ : it->second;
+}
+
+};  // namespace core
+};  // namespace pfp
@@ -0,0 +1,165 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class LatencyObserver
+ * Observer which measures packet latency from the data_written and
+ * data_read notifications, keyed by TrType::id(), without the debugger.
+ *  - Per hop: the time between two consecutive sightings of a packet, in a
+ *    histogram per (from module, to module) pair. A write followed by a read
+ *    is the time on the link/queue between two modules; a read followed by
+ *    a write is the time spent inside a module.
+ *  - End to end: from the first sighting of a packet to the event of the
+ *    egress kind (by default a write) at an egress module, per (ingress,
+ *    egress) pair and overall.
+ * A packet is forgotten as soon as it leaves through an egress module or is
+ * dropped; packets that never do are evicted oldest first once more than
+ * max_in_flight are tracked, so memory stays bounded in long runs. A packet
+ * first sighted at an egress module is not tracked, so an egress module
+ * which reads and then writes a packet does not start a new one.
+ * Latencies are in picoseconds, p50/p99/p999 are in the report printed at
+ * the end of the simulation.
+ *
+ *   auto latency = std::make_shared<LatencyObserver>(
+ *         std::vector<std::string>{"npu.egress"});
+ *   top->attach_observer(latency);
+ */
+#ifndef CORE_LATENCYOBSERVER_H_
+#define CORE_LATENCYOBSERVER_H_
+
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "EventObserver.h"
+#include "Histogram.h"
+#include "NameTable.h"
+
+namespace pfp {
+namespace core {
+
+class LatencyObserver : public EventObserver {
+ public:
+  /**
+   * Construct a LatencyObserver
+   * @param egress_modules  Fully qualified names of the modules where
+   *                        packets leave the model
+   * @param max_in_flight   Largest number of packets tracked at once
+   * @param out             Stream receiving the end of simulation report
+   * @param egress_kind     Event (DataWritten or DataRead) by which a packet
+   *                        leaves an egress module
+   */
+  explicit LatencyObserver(const std::vector<std::string>& egress_modules,
+        std::size_t max_in_flight = 1 << 20, std::ostream& out = std::cout,
+        ObserverEvent::Kind egress_kind = ObserverEvent::Kind::DataWritten);
+  ~LatencyObserver();
+
+  void observe(const ObserverEvent& event) override;
+
+  uint32_t interests() const override {
+    return ObserverEvent::DataFlow | ObserverEvent::Drops;
+  }
+
+  /**
+   * Write the latency histograms
+   * @param os  Stream to write to
+   */
+  void report(std::ostream& os) const;
+
+  //! End to end latency of all packets that reached an egress module
+  const Histogram& end_to_end() const {
+    return end_to_end_;
+  }
+
+  /**
+   * Latency between two modules
+   * @param from  Module of the earlier sighting
+   * @param to    Module of the later sighting
+   * @return      Histogram, empty if no packet went from one to the other
+   */
+  const Histogram& hop(const std::string& from, const std::string& to) const;
+
+  //! Number of packets currently tracked
+  std::size_t in_flight() const {
+    return in_flight_.size();
+  }
+
+  //! Packets forgotten because max_in_flight was exceeded
+  uint64_t evicted() const {
+    return evicted_;
+  }
+
+  //! Packets forgotten because they were dropped
+  uint64_t dropped() const {
+    return dropped_;
+  }
+
+ private:
+  struct InFlight {
+    NameTable::Id ingress;
+    double first;         /*!< Time of the first sighting */
+    NameTable::Id last_module;
+    double last;          /*!< Time of the latest sighting */
+    //! Position of the packet in arrival_order_
+    std::list<std::size_t>::iterator arrival;
+  };
+
+  static uint64_t pair_key(NameTable::Id from, NameTable::Id to) {
+    return (static_cast<uint64_t>(from) << 32) | to;
+  }
+  void evict_oldest();
+  void forget(std::unordered_map<std::size_t, InFlight>::iterator packet);
+
+  std::unordered_set<NameTable::Id> egress_;
+  const std::size_t max_in_flight_;
+  std::ostream& out_;
+  const ObserverEvent::Kind egress_kind_;
+  std::unordered_map<std::size_t, InFlight> in_flight_;
+  //! Ids of the packets in flight in order of first sighting, for eviction
+  std::list<std::size_t> arrival_order_;
+  std::unordered_map<uint64_t, Histogram> hops_;
+  std::unordered_map<uint64_t, Histogram> paths_;  /*!< Ingress to egress */
+  Histogram end_to_end_;
+  const Histogram empty_;
+  uint64_t evicted_;
+  uint64_t dropped_;
+  std::size_t end_of_simulation_handle_;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_LATENCYOBSERVER_H_
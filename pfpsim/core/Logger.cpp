@@ -0,0 +1,434 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "PFPContext.h"
+#include "PFPObject.h"
+#include "StringUtils.h"
+#include "promptcolors.h"
+
+namespace pfp {
+namespace core {
+
+namespace {
+//! Failed pops before the background thread goes to sleep
+const unsigned spins_before_sleep = 64;
+//! Longest sleep of the background thread, bounds the latency of a lost wake
+const std::chrono::milliseconds max_sleep(1);
+
+//! Copy text without the terminal colour sequences of promptcolors.h
+void write_plain(std::ostream& out, const std::string& text) {
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == '\033' && i + 1 < text.size() && text[i + 1] == '[') {
+      const std::size_t end = text.find('m', i);
+      if (end != std::string::npos) {
+        i = end;
+        continue;
+      }
+    }
+    out.put(text[i]);
+  }
+}
+std::vector<std::string> split(const std::string& text, char separator) {
+  std::vector<std::string> fields;
+  std::string::size_type start = 0;
+  for (;;) {
+    const auto end = text.find(separator, start);
+    fields.push_back(text.substr(start, end - start));
+    if (end == std::string::npos) {
+      return fields;
+    }
+    start = end + 1;
+  }
+}
+
+double parse_number(const std::string& text, const std::string& spec) {
+  char* end;
+  const double number = std::strtod(text.c_str(), &end);
+  if (text.empty() || *end != '\0' || number < 0) {
+    throw std::invalid_argument("Invalid number " + text + " in log route "
+          + spec);
+  }
+  return number;
+}
+}  // namespace
+
+LogRoute LogRoute::parse(const std::string& spec) {
+  const auto fields = split(spec, ':');
+  if (fields.size() > 5) {
+    throw std::invalid_argument("Too many fields in log route " + spec);
+  }
+  LogRoute route;
+  route.module = fields[0];
+  if (fields.size() > 1 && !fields[1].empty()) {
+    const auto& names = PFPConfig::get().verbositylevels;
+    for (auto& level : split(fields[1], '+')) {
+      auto it = std::find(names.begin(), names.end(), level);
+      if (it == names.end()) {
+        throw std::invalid_argument("Invalid level " + level
+              + " in log route " + spec);
+      }
+      route.levels |= 1u << (it - names.begin());
+    }
+  }
+  if (fields.size() > 2) {
+    route.sink = fields[2];
+  }
+  if (fields.size() > 3 && !fields[3].empty()) {
+    route.rate = parse_number(fields[3], spec);
+  }
+  if (fields.size() > 4 && !fields[4].empty()) {
+    route.burst = std::max(1.0, parse_number(fields[4], spec));
+  }
+  return route;
+}
+
+Logger& Logger::get() {
+  static Logger instance;
+  return instance;
+}
+
+Logger::~Logger() {
+  close();
+  if (summary_registered_) {
+    PFPContext::get_current_context().cancel_end_of_simulation(
+          summary_handle_);
+  }
+}
+
+void Logger::open(const std::string& directory, std::size_t capacity) {
+  if (ring_) {
+    return;
+  }
+  const std::string dir = directory.empty() ? OUTPUTDIR : directory;
+  file_.open(join_path(dir, "npulog.txt"));
+  if (!file_) {
+    throw std::runtime_error("Cannot open log file in " + dir);
+  }
+  file_ << std::fixed << std::setprecision(3);
+  ring_.reset(new ConcurrentRing<Record>(capacity));
+  stop_.store(false, std::memory_order_release);
+  end_of_simulation_handle_ = PFPContext::get_current_context()
+        .at_end_of_simulation([this]() { flush(); },
+              PFPContext::EndPhase::Drain);
+  thread_ = std::thread(&Logger::run, this);
+}
+
+void Logger::close() {
+  if (!ring_) {
+    return;
+  }
+  PFPContext::get_current_context().cancel_end_of_simulation(
+        end_of_simulation_handle_);
+  stop_.store(true, std::memory_order_release);
+  wake();
+  thread_.join();
+  ring_.reset();
+  file_.close();
+}
+
+void Logger::flush() {
+  wake();
+  while (written_.load(std::memory_order_acquire) != pushed_) {
+    std::this_thread::yield();
+  }
+}
+
+void Logger::add_route(const LogRoute& route) {
+  if (ring_) {
+    flush();  // the background thread is idle and does not use sinks_
+  }
+  if (sinks_.empty()) {
+    sinks_.emplace_back(new Sink());  // default_sink
+  }
+  uint32_t sink = default_sink;
+  if (route.sink == "none") {
+    sink = no_sink;
+  } else if (!route.sink.empty()) {
+    sink = 0;
+    while (sink < sinks_.size() && sinks_[sink]->file != route.sink) {
+      ++sink;
+    }
+    if (sink == sinks_.size()) {
+      sinks_.emplace_back(new Sink());
+      sinks_.back()->file = route.sink;
+    }
+  }
+  routes_.push_back(route);
+  route_sinks_.push_back(sink);
+  ++generation_;
+  states_.clear();
+  update_levels();
+  if (!summary_registered_) {
+    summary_handle_ = PFPContext::get_current_context()
+          .at_end_of_simulation([this]() { write_summary(); });
+    summary_registered_ = true;
+  }
+}
+
+void Logger::clear_routes() {
+  routes_.clear();
+  route_sinks_.clear();
+  ++generation_;
+  states_.clear();
+  update_levels();
+}
+
+void Logger::update_levels() {
+  uint32_t levels = 0;
+  for (auto& route : routes_) {
+    levels |= route.levels;
+  }
+  PFPConfig::set_routed_log_levels(levels);
+}
+
+LogCounts Logger::counts(const PFPObject* module) const {
+  const unsigned generation = module ? module->log_generation_
+        : unowned_generation_;
+  if (generation != generation_) {
+    return LogCounts();
+  }
+  return states_[module ? module->log_state_ : unowned_state_].counts;
+}
+
+Logger::ModuleState& Logger::state(const PFPObject* module) {
+  unsigned& generation = module ? module->log_generation_
+        : unowned_generation_;
+  std::size_t& index = module ? module->log_state_ : unowned_state_;
+  if (generation != generation_) {
+    ModuleState state;
+    const std::string module_path = module
+          ? module->fully_qualified_module_name() : "";
+    state.name = !module ? "-" : module_path.empty() ? module->module_name()
+          : module_path;
+    // Longest matching path, the last route added among equals
+    state.route = -1;
+    std::size_t matched = 0;
+    for (std::size_t i = 0; i < routes_.size(); ++i) {
+      const std::string& path = routes_[i].module;
+      const bool match = path.empty() || module_path == path
+            || (module_path.size() > path.size()
+                  && module_path.compare(0, path.size(), path) == 0
+                  && module_path[path.size()] == '.');
+      if (match && (state.route < 0 || path.size() >= matched)) {
+        state.route = static_cast<int>(i);
+        matched = path.size();
+      }
+    }
+    state.tokens = state.route < 0 ? 0 : routes_[state.route].burst;
+    state.last_refill = sc_time_stamp().to_seconds();
+    index = states_.size();
+    states_.push_back(state);
+    generation = generation_;
+  }
+  return states_[index];
+}
+
+bool Logger::admit(PFPConfig::verbosity level, ModuleState& module) {
+  const LogRoute* route = module.route < 0 ? nullptr
+        : &routes_[module.route];
+  const bool wanted = route && route->levels
+        ? ((route->levels >> level) & 1u) != 0
+        : level == PFPConfig::active_verbosity;
+  if (!wanted) {
+    ++module.counts.filtered;
+    return false;
+  }
+  if (route && route->rate > 0) {
+    // Token bucket refilled with simulated time
+    const double now = sc_time_stamp().to_seconds();
+    module.tokens = std::min(route->burst,
+          module.tokens + (now - module.last_refill) * route->rate);
+    module.last_refill = now;
+    if (module.tokens < 1) {
+      ++module.counts.rate_limited;
+      return false;
+    }
+    module.tokens -= 1;
+  }
+  return true;
+}
+
+bool Logger::begin(PFPConfig::verbosity level, const PFPObject* module) {
+  uint32_t sink = default_sink;
+  if (!routes_.empty()) {
+    ModuleState& state = this->state(module);
+    if (!admit(level, state)) {
+      return false;
+    }
+    if (state.route >= 0) {
+      sink = route_sinks_[state.route];
+    }
+    if (sink == no_sink) {
+      ++state.counts.filtered;
+      return false;
+    }
+    ++state.counts.emitted;
+  }
+  if (ring_ || sink != default_sink || depth_ > 0) {
+    // Nested statements go with the one that encloses them
+    if (depth_++ == 0) {
+      current_sink_ = sink;
+      capture_.str(std::string());
+      saved_cout_ = std::cout.rdbuf(&capture_);
+    }
+    return true;
+  }
+  const sc_core::sc_time now = sc_time_stamp();
+  std::cout << txtgrn << std::fixed << now.to_double()/1000 << " ns "
+        << txtrst << "@ ";
+  if (module) {
+    std::cout << On_Purple << module->module_name();
+  }
+  std::cout << txtrst << " ";
+  return true;
+}
+
+void Logger::end(PFPConfig::verbosity level, const PFPObject* module) {
+  if (depth_ == 0) {
+    std::cout << txtrst;
+    return;
+  }
+  if (--depth_ != 0) {
+    return;
+  }
+  std::cout.rdbuf(saved_cout_);
+  Record record{static_cast<uint8_t>(level), current_sink_,
+        module ? module->module_name_id() : NameTable::get().intern(""),
+        sc_time_stamp().to_double(), capture_.str()};
+  if (!ring_) {
+    write(record);
+    return;
+  }
+  while (!ring_->try_push(std::move(record))) {
+    wake();
+    std::this_thread::yield();
+  }
+  ++pushed_;
+  if (sleeping_.load(std::memory_order_relaxed)) {
+    wake();
+  }
+}
+
+void Logger::write(const Record& record) {
+  std::ostream* out = &file_;
+  if (record.sink != default_sink) {
+    Sink& sink = *sinks_[record.sink];
+    if (!sink.stream.is_open()) {
+      sink.stream.open(join_path(OUTPUTDIR, sink.file));
+      sink.stream << std::fixed << std::setprecision(3);
+    }
+    out = &sink.stream;
+  }
+  const auto& levels = PFPConfig::get().verbositylevels;
+  *out << record.sim_time / 1000 << " ns ["
+        << (record.level < levels.size() ? levels[record.level] : "?")
+        << "] @ " << NameTable::get().name(record.module) << " ";
+  write_plain(*out, record.text);
+  if (record.text.empty() || record.text.back() != '\n') {
+    *out << '\n';
+  }
+}
+
+void Logger::write_summary() {
+  if (ring_) {
+    flush();
+  } else {
+    for (auto& sink : sinks_) {
+      sink->stream.flush();
+    }
+  }
+  if (states_.empty()) {
+    return;
+  }
+  std::ofstream csv(join_path(OUTPUTDIR, "log_summary.csv"));
+  csv << "module,route,emitted,rate_limited,filtered\n";
+  uint64_t rate_limited = 0, filtered = 0;
+  for (auto& state : states_) {
+    csv << state.name << ","
+        << (state.route < 0 ? "" : routes_[state.route].module) << ","
+        << state.counts.emitted << "," << state.counts.rate_limited << ","
+        << state.counts.filtered << "\n";
+    rate_limited += state.counts.rate_limited;
+    filtered += state.counts.filtered;
+  }
+  std::cout << "Log routes: " << rate_limited << " statements rate limited, "
+      << filtered << " filtered (see log_summary.csv)" << std::endl;
+}
+
+void Logger::run() {
+  Record record;
+  std::size_t written = 0;
+  unsigned idle = 0;
+  for (;;) {
+    if (ring_->try_pop(record)) {
+      write(record);
+      ++written;
+      idle = 0;
+    } else if (written != written_.load(std::memory_order_relaxed)) {
+      // Caught up: make the records visible in the files
+      file_.flush();
+      for (auto& sink : sinks_) {
+        sink->stream.flush();
+      }
+      written_.store(written, std::memory_order_release);
+    } else if (stop_.load(std::memory_order_acquire)) {
+      // Everything pushed before stop_ was set is visible now
+      if (ring_->empty()) {
+        return;
+      }
+    } else if (++idle < spins_before_sleep) {
+      std::this_thread::yield();
+    } else {
+      std::unique_lock<std::mutex> lock(mutex_);
+      sleeping_.store(true, std::memory_order_relaxed);
+      wake_.wait_for(lock, max_sleep);
+      sleeping_.store(false, std::memory_order_relaxed);
+    }
+  }
+}
+
+void Logger::wake() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  wake_.notify_one();
+}
+
+};  // namespace core
+};  // namespace pfp
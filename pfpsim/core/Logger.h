@@ -0,0 +1,304 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class Logger
+ * Backend of the npulog macros (see PFPObject.h).
+ * Three things make a log statement cheap:
+ *  - Levels left out of the PFP_LOG_LEVELS mask (one bit per
+ *    PFPConfig::verbosity, all set by default) are compiled out: the
+ *    statement is guarded by a constant false and generates no code. For
+ *    instance -DPFP_LOG_LEVELS=0 removes all logging from a model.
+ *  - The runtime check is one compare against
+ *    PFPConfig::active_verbosity, a copy of the verbosity level.
+ *  - Once open() is called, an enabled statement no longer writes to the
+ *    console: its output is captured and pushed, with the level, the
+ *    interned module name and the raw simulation time, into a lock-free
+ *    ring. A background thread formats the records into OUTPUTDIR/npulog.txt
+ *    (colour codes removed). Without open() statements are written to
+ *    std::cout as they are executed, as before.
+ * The ring is flushed at the end of the simulation and by close().
+ *
+ * Log routes (see LogRoute) select, per module path, which levels are
+ * logged, where they go and how many statements per simulated second may
+ * pass. The route of a module is looked up once and cached in the module;
+ * a statement that is filtered out or over its rate is counted and skipped
+ * before its body runs. The counts are written to OUTPUTDIR/log_summary.csv
+ * at the end of the simulation.
+ */
+#ifndef CORE_LOGGER_H_
+#define CORE_LOGGER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ConcurrentRing.h"
+#include "NameTable.h"
+#include "PFPConfig.h"
+
+#ifndef PFP_LOG_LEVELS
+#define PFP_LOG_LEVELS 0xFFFFFFFFu
+#endif
+
+//! Whether statements of a verbosity level are compiled in
+#define PFP_LOG_COMPILED(LEVEL)                                               \
+  (((PFP_LOG_LEVELS) >> pfp::core::PFPConfig::LEVEL) & 1u)
+
+//! Whether statements of a verbosity level may run, in some module
+#define PFP_LOG_ENABLED(LEVEL)                                                \
+  (PFP_LOG_COMPILED(LEVEL)                                                    \
+      && ((pfp::core::PFPConfig::active_log_levels                            \
+            >> pfp::core::PFPConfig::LEVEL) & 1u))
+
+namespace pfp {
+namespace core {
+
+class PFPObject;
+
+/**
+ * Where the log statements of a subtree of modules go
+ */
+struct LogRoute {
+  //! Path of the module (see PFPObject::fully_qualified_module_name),
+  //! covering its submodules; empty for all modules. The longest matching
+  //! path applies.
+  std::string module;
+  //! Levels logged, one bit per PFPConfig::verbosity; 0 for the level set
+  //! with --verbosity. Other levels are enabled for these modules only.
+  uint32_t levels = 0;
+  //! File in OUTPUTDIR; empty for the default output, "none" to discard
+  std::string sink;
+  //! Statements per second of simulated time, per module; 0 for no limit
+  double rate = 0;
+  //! Statements that may pass at once before rate applies
+  double burst = 1;
+
+  /**
+   * Parse module[:levels[:sink[:rate[:burst]]]], the levels separated by
+   * '+', for instance "npu.pe0:debug+profile:pe0.log:1e6:100"
+   * @param spec  Route description
+   * @return      Parsed route
+   * @throws std::invalid_argument if the description is malformed
+   */
+  static LogRoute parse(const std::string& spec);
+};
+
+//! Statements of one module, see Logger::counts
+struct LogCounts {
+  uint64_t emitted = 0;       /*!< Statements logged */
+  uint64_t rate_limited = 0;  /*!< Skipped by the rate limit of the route */
+  uint64_t filtered = 0;      /*!< Skipped for their level */
+};
+
+class Logger {
+ public:
+  /**
+   * Get a reference to the logger
+   * @return  Singleton reference to the logger
+   */
+  static Logger& get();
+
+  /**
+   * Write log statements from a background thread from now on
+   * @param directory  Directory of npulog.txt; OUTPUTDIR when empty
+   * @param capacity   Records buffered before a statement has to wait
+   */
+  void open(const std::string& directory = "",
+        std::size_t capacity = 1 << 16);
+
+  /**
+   * Write all buffered records and go back to writing to std::cout
+   */
+  void close();
+
+  /**
+   * Wait until every record pushed so far is written
+   */
+  void flush();
+
+  //! Whether statements go to the background thread
+  bool is_open() const {
+    return ring_ != nullptr;
+  }
+
+  /**
+   * Add a log route; routes added later win over earlier ones with the
+   * same module path
+   * @param route  Route to add
+   */
+  void add_route(const LogRoute& route);
+
+  /**
+   * Remove all log routes and their counts
+   */
+  void clear_routes();
+
+  /**
+   * Statement counts of a module
+   * @param module  Module, nullptr for statements outside modules
+   * @return        Counts since its route was last looked up
+   */
+  LogCounts counts(const PFPObject* module) const;
+
+  /**
+   * Decide whether a statement runs, and if so start capturing its output
+   * or write its prefix to std::cout
+   * @param level   Verbosity level of the statement
+   * @param module  Module logging, nullptr for none
+   * @return        Whether the statement runs; if so end must follow
+   */
+  bool begin(PFPConfig::verbosity level, const PFPObject* module);
+
+  /**
+   * Finish a statement for which begin returned true
+   * @param level   Verbosity level of the statement
+   * @param module  Module given to begin
+   */
+  void end(PFPConfig::verbosity level, const PFPObject* module);
+
+  /**
+   * Write the statement counts of every routed module to
+   * OUTPUTDIR/log_summary.csv; done at the end of the simulation
+   */
+  void write_summary();
+
+  //! Number of records written and flushed to the file
+  std::size_t written() const {
+    return written_.load(std::memory_order_acquire);
+  }
+
+ private:
+  //! One log statement, formatted by the background thread
+  struct Record {
+    uint8_t level;
+    uint32_t sink;          /*!< Index in sinks_ */
+    NameTable::Id module;
+    double sim_time;        /*!< In the SystemC time resolution (ps) */
+    std::string text;
+  };
+
+  //! Output file of routes; sinks_[default_sink] is the default output
+  struct Sink {
+    std::string file;
+    std::ofstream stream;
+  };
+
+  //! Route and rate limit of a module, cached in the module
+  struct ModuleState {
+    std::string name;       /*!< Path of the module, for the summary */
+    int route;              /*!< Index in routes_, -1 for none */
+    double tokens;
+    double last_refill;     /*!< Simulation time in seconds */
+    LogCounts counts;
+  };
+
+  static const uint32_t default_sink = 0;
+  static const uint32_t no_sink = ~uint32_t(0);
+
+  Logger() = default;
+  ~Logger();
+  Logger(const Logger&) = delete;
+  Logger& operator=(const Logger&) = delete;
+
+  ModuleState& state(const PFPObject* module);
+  bool admit(PFPConfig::verbosity level, ModuleState& module);
+  void write(const Record& record);
+  void update_levels();
+
+  void run();
+  void wake();
+
+  std::unique_ptr<ConcurrentRing<Record>> ring_;
+  std::ofstream file_;
+  std::thread thread_;
+  std::stringbuf capture_;            /*!< Output of the current statement */
+  std::streambuf* saved_cout_ = nullptr;
+  unsigned depth_ = 0;                /*!< Nesting of statements */
+  std::size_t pushed_ = 0;
+  std::atomic<std::size_t> written_{0};
+  std::atomic<bool> stop_{false};
+  std::atomic<bool> sleeping_{false};
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::size_t end_of_simulation_handle_ = 0;
+
+  std::vector<LogRoute> routes_;
+  std::vector<uint32_t> route_sinks_;   /*!< Sink of each route */
+  std::vector<std::unique_ptr<Sink>> sinks_;
+  std::vector<ModuleState> states_;
+  //! Incremented when routes change, invalidates the states cached in
+  //! the modules
+  unsigned generation_ = 1;
+  std::size_t unowned_state_ = 0;       /*!< State of statements outside */
+  unsigned unowned_generation_ = 0;     /*!< modules */
+  uint32_t current_sink_ = default_sink;  /*!< Sink of the statement */
+  bool summary_registered_ = false;
+  std::size_t summary_handle_ = 0;
+};
+
+/**
+ * Scope of one enabled log statement, see the npulog macros
+ */
+class LogStatement {
+ public:
+  LogStatement(PFPConfig::verbosity level, const PFPObject* module)
+  : level_(level), module_(module),
+    runs_(Logger::get().begin(level, module)) {
+  }
+
+  ~LogStatement() {
+    if (runs_) {
+      Logger::get().end(level_, module_);
+    }
+  }
+
+  //! Whether the body of the statement runs
+  bool runs() const {
+    return runs_;
+  }
+
+ private:
+  const PFPConfig::verbosity level_;
+  const PFPObject* const module_;
+  const bool runs_;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_LOGGER_H_
@@ -38,14 +38,18 @@
  * @class MTQueue
  * A multiple-producer, multiple-consumer, thread-safe queue implemented using SystemC primitives
  * The MTQueue is used as the input buffer in the NPU modules
+ * The optional Stats parameter selects an instrumentation policy (QueueStats.h)
  */
 #ifndef CORE_MTQUEUE_H_
 #define CORE_MTQUEUE_H_
 
+#include <iterator>
 #include <queue>
+#include <utility>
 #include "systemc.h"
+#include "QueueStats.h"
 
-template <typename T>
+template <typename T, typename Stats = pfp::core::NoQueueStats>
 class MTQueue {
  public:
   /**
@@ -67,6 +71,7 @@ class MTQueue {
     // sem_.wait();
     auto item = queue_.front();
     queue_.pop();
+    stats_.on_pop(queue_.size());
     mutex_.unlock();
     // sem_.post();
     return item;
@@ -84,10 +89,91 @@ class MTQueue {
     // sem_.wait();
     item = queue_.front();
     queue_.pop();
+    stats_.on_pop(queue_.size());
     mutex_.unlock();
     // sem_.post();
   }
 
+  /**
+   * Pop the top element if there is one, without blocking
+   * @param  Output argument
+   * @return True if an element was popped
+   */
+  bool try_pop(T& item) {
+    if (queue_.empty()) {
+      return false;
+    }
+    mutex_.lock();
+    item = std::move(queue_.front());
+    queue_.pop();
+    stats_.on_pop(queue_.size());
+    mutex_.unlock();
+    return true;
+  }
+
+  /**
+   * Pop the top element, waiting at most timeout for one to arrive
+   * @param  Output argument
+   * @param  Maximum simulation time to wait
+   * @return True if an element was popped, false on timeout
+   */
+  bool pop(T& item, const sc_time& timeout) {
+    const sc_time deadline = sc_time_stamp() + timeout;
+    while (queue_.empty()) {
+      const sc_time now = sc_time_stamp();
+      if (now >= deadline) {
+        return false;
+      }
+      wait(deadline - now, cond_);
+    }
+    return try_pop(item);
+  }
+
+  /**
+   * Wait until the MTQueue is not empty, then move up to max_items elements
+   * into out under a single lock acquisition
+   * @param  Output iterator receiving the elements
+   * @param  Maximum number of elements to pop
+   * @return Number of elements popped
+   */
+  template <typename OutputIt>
+  std::size_t pop_up_to(OutputIt out, std::size_t max_items) {
+    while (queue_.empty()) {
+      wait(cond_);
+    }
+    return take(out, max_items);
+  }
+
+  /**
+   * Move every element currently in the MTQueue into the back of a container,
+   * without blocking
+   * @param  Container supporting push_back
+   * @return Number of elements moved
+   */
+  template <typename Container>
+  std::size_t drain_into(Container& container) {
+    return take(std::back_inserter(container), queue_.size());
+  }
+
+  /**
+   * Push a range of items onto the MTQueue with a single lock acquisition
+   * and a single notification
+   * @param  Range of items to push
+   */
+  template <typename InputIt>
+  void push_n(InputIt first, InputIt last) {
+    if (first == last) {
+      return;
+    }
+    mutex_.lock();
+    for (; first != last; ++first) {
+      queue_.push(*first);
+      stats_.on_push(queue_.size());
+    }
+    mutex_.unlock();
+    cond_.notify();
+  }
+
   /**
    * Push an item onto the MTQueue
    * @param  Item to push
@@ -96,6 +182,7 @@ class MTQueue {
     mutex_.lock();
     // sem_.wait();
     queue_.push(item);
+    stats_.on_push(queue_.size());
     // sem_.post();
     mutex_.unlock();
     cond_.notify();
@@ -109,6 +196,7 @@ class MTQueue {
     mutex_.lock();
     // sem_.wait();
     queue_.push(std::move(item));
+    stats_.on_push(queue_.size());
     // sem_.post();
     mutex_.unlock();
     cond_.notify();
@@ -123,10 +211,36 @@ class MTQueue {
     mutex_.unlock();
   }
 
+  /**
+   * Access the instrumentation policy (see QueueStats.h)
+   * @return  Statistics recorded for this queue
+   */
+  const Stats& stats() const {
+    return stats_;
+  }
+
+  Stats& stats() {
+    return stats_;
+  }
+
  private:
+  template <typename OutputIt>
+  std::size_t take(OutputIt out, std::size_t max_items) {
+    std::size_t count = 0;
+    mutex_.lock();
+    for (; count < max_items && !queue_.empty(); ++count) {
+      *out++ = std::move(queue_.front());
+      queue_.pop();
+      stats_.on_pop(queue_.size());
+    }
+    mutex_.unlock();
+    return count;
+  }
+
   std::queue<T> queue_;  /*!< Internal queue */
   sc_mutex mutex_;    /*!< Guard */
   sc_event cond_;      /*!< Event to notify when not empty */
+  Stats stats_;        /*!< Instrumentation policy */
   // sc_semaphore sem_;
 };
 
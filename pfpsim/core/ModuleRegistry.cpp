@@ -0,0 +1,96 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "ModuleRegistry.h"
+#include <string>
+#include <vector>
+#include "PFPObject.h"
+
+namespace pfp {
+namespace core {
+
+const ModuleRegistry::Id ModuleRegistry::invalid_id;
+
+ModuleRegistry& ModuleRegistry::get() {
+  static ModuleRegistry instance;
+  return instance;
+}
+
+void ModuleRegistry::build(PFPObject* top) {
+  for (auto& entry : entries_) {
+    entry.module->module_id_ = invalid_id;
+  }
+  entries_.clear();
+  by_path_.clear();
+  if (top) {
+    add(top, invalid_id, "");
+  }
+}
+
+ModuleRegistry::Id ModuleRegistry::add(PFPObject* module, Id parent,
+      const std::string& path) {
+  NameTable& names = NameTable::get();
+  const Id id = static_cast<Id>(entries_.size());
+  Entry entry;
+  entry.module = module;
+  entry.parent = parent;
+  entry.name = names.intern(module->module_name());
+  entry.path = names.intern(path);
+  entries_.push_back(entry);
+  by_path_.emplace(entry.path, id);
+
+  module->module_id_ = id;
+  module->fully_qualified_module_name_ = path;
+  module->fully_qualified_module_name_id_ = entry.path;
+  module->module_name_id_ = entry.name;
+
+  for (auto& child : module->GetChildModules()) {
+    const std::string child_path = path.empty()
+          ? child.second->module_name()
+          : path + "." + child.second->module_name();
+    const Id child_id = add(child.second, id, child_path);
+    entries_[id].children.push_back(child_id);
+  }
+  return id;
+}
+
+ModuleRegistry::Id ModuleRegistry::find(const std::string& path) const {
+  const NameTable::Id id = NameTable::get().find(path);
+  return id == NameTable::invalid ? invalid_id : find(id);
+}
+
+ModuleRegistry::Id ModuleRegistry::find(NameTable::Id path) const {
+  auto it = by_path_.find(path);
+  return it == by_path_.end() ? invalid_id : it->second;
+}
+
+};  // namespace core
+};  // namespace pfp
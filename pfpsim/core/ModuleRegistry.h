@@ -0,0 +1,140 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class ModuleRegistry
+ * Process-wide index of the PFPObject hierarchy.
+ * PFPContext::ensure_top_initialized builds the registry once the top
+ * module and all its submodules exist: every module gets a small integer
+ * id, in depth-first order from top (id 0), with its parent, its children
+ * and its fully qualified name, interned in the NameTable. Each PFPObject's
+ * cached names are filled in at the same time, so neither
+ * fully_qualified_module_name() nor the observer events build strings
+ * afterwards.
+ * The registry is only written during elaboration, and is read-only (and
+ * safe to read from any thread) once the simulation runs.
+ */
+#ifndef CORE_MODULEREGISTRY_H_
+#define CORE_MODULEREGISTRY_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "NameTable.h"
+
+namespace pfp {
+namespace core {
+
+class PFPObject;
+
+class ModuleRegistry {
+ public:
+  typedef uint32_t Id;
+  static const Id invalid_id = ~Id(0);
+
+  /**
+   * Get a reference to the module registry
+   * @return  Singleton reference to the module registry
+   */
+  static ModuleRegistry& get();
+
+  /**
+   * Index a module hierarchy, replacing any previous content
+   * @param top  Root of the hierarchy
+   */
+  void build(PFPObject* top);
+
+  //! Number of registered modules
+  std::size_t size() const {
+    return entries_.size();
+  }
+
+  /**
+   * Find a module by its fully qualified name
+   * @param path  Fully qualified name, e.g. "npu.ingress" ("" for top)
+   * @return      Id of the module, invalid_id if there is none
+   */
+  Id find(const std::string& path) const;
+  /**
+   * Find a module by the interned fully qualified name carried by observer
+   * events (e.g. ObserverEvent::module of the Data* kinds)
+   * @param path  NameTable id of the fully qualified name
+   * @return      Id of the module, invalid_id if there is none
+   */
+  Id find(NameTable::Id path) const;
+
+  PFPObject* module(Id id) const {
+    return entries_[id].module;
+  }
+  //! Parent of a module, invalid_id for top
+  Id parent(Id id) const {
+    return entries_[id].parent;
+  }
+  const std::vector<Id>& children(Id id) const {
+    return entries_[id].children;
+  }
+  //! Fully qualified name of a module
+  const std::string& path(Id id) const {
+    return NameTable::get().name(entries_[id].path);
+  }
+  //! Interned fully qualified name of a module
+  NameTable::Id path_id(Id id) const {
+    return entries_[id].path;
+  }
+  //! Interned module_name() of a module
+  NameTable::Id name_id(Id id) const {
+    return entries_[id].name;
+  }
+
+ private:
+  struct Entry {
+    PFPObject* module;
+    Id parent;
+    NameTable::Id name;
+    NameTable::Id path;
+    std::vector<Id> children;
+  };
+
+  ModuleRegistry() = default;
+  ModuleRegistry(const ModuleRegistry &) = delete;
+  ModuleRegistry& operator=(const ModuleRegistry &) = delete;
+
+  Id add(PFPObject* module, Id parent, const std::string& path);
+
+  std::vector<Entry> entries_;  /*!< Indexed by module id */
+  std::unordered_map<NameTable::Id, Id> by_path_;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_MODULEREGISTRY_H_
@@ -0,0 +1,101 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "NameTable.h"
+#include <string>
+
+namespace pfp {
+namespace core {
+
+NameTable::NameTable() : size_(0) {
+  for (auto& chunk : chunks_) {
+    chunk.store(nullptr, std::memory_order_relaxed);
+  }
+  // Id 0 is always the empty string
+  intern("");
+}
+
+NameTable::~NameTable() {
+  for (auto& chunk : chunks_) {
+    delete[] chunk.load(std::memory_order_relaxed);
+  }
+}
+
+NameTable& NameTable::get() {
+  static NameTable instance;
+  return instance;
+}
+
+NameTable::Id NameTable::intern(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = ids_.find(name);
+  if (it != ids_.end()) {
+    return it->second;
+  }
+  const Id id = size_;
+  unsigned chunk;
+  std::size_t offset;
+  locate(id, &chunk, &offset);
+  std::string* strings = chunks_[chunk].load(std::memory_order_relaxed);
+  if (!strings) {
+    strings = new std::string[std::size_t(1) << (first_chunk_bits + chunk)];
+    chunks_[chunk].store(strings, std::memory_order_release);
+  }
+  // Written before the id escapes; whoever gets the id gets the string
+  strings[offset] = name;
+  ++size_;
+  ids_.emplace(name, id);
+  return id;
+}
+
+NameTable::Id NameTable::find(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = ids_.find(name);
+  return it == ids_.end() ? invalid : it->second;
+}
+
+void NameTable::locate(Id id, unsigned* chunk, std::size_t* offset) {
+  const uint64_t position = static_cast<uint64_t>(id)
+        + (uint64_t(1) << first_chunk_bits);
+  const unsigned msb = 63 - __builtin_clzll(position);
+  *chunk = msb - first_chunk_bits;
+  *offset = position - (uint64_t(1) << msb);
+}
+
+const std::string& NameTable::name(Id id) const {
+  unsigned chunk;
+  std::size_t offset;
+  locate(id, &chunk, &offset);
+  return chunks_[chunk].load(std::memory_order_acquire)[offset];
+}
+
+};  // namespace core
+};  // namespace pfp
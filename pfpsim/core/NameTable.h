@@ -0,0 +1,114 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class NameTable
+ * Process-wide table of interned strings.
+ * Module, counter and reason names are interned once and then travel
+ * through the observer pipeline as small integer ids; name() turns an id
+ * back into a reference to the single stored copy of the string.
+ * intern() is guarded by a mutex so that observers running on their own
+ * threads (AsyncObserver) can resolve names while the model interns more.
+ * name() takes no lock: strings are stored in chunks that never move, and
+ * a chunk is published before any id in it is handed out.
+ */
+#ifndef CORE_NAMETABLE_H_
+#define CORE_NAMETABLE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace pfp {
+namespace core {
+
+class NameTable {
+ public:
+  typedef uint32_t Id;
+  //! Id of no string, returned by find for strings never interned
+  static const Id invalid = ~Id(0);
+
+  /**
+   * Get a reference to the name table
+   * @return  Singleton reference to the name table
+   */
+  static NameTable& get();
+
+  /**
+   * Get the id of a string, adding it to the table if needed
+   * @param name  String to intern
+   * @return      Id of the string
+   */
+  Id intern(const std::string& name);
+
+  /**
+   * Get the id of a string without adding it, for lookups by name that
+   * must not grow the table
+   * @param name  String to look up
+   * @return      Id of the string, or invalid if it was never interned
+   */
+  Id find(const std::string& name) const;
+
+  /**
+   * Get the string with the given id
+   * @param id  Id returned by intern
+   * @return    Reference to the interned string, valid for the whole run
+   */
+  const std::string& name(Id id) const;
+
+ private:
+  NameTable();
+  ~NameTable();
+
+  NameTable(const NameTable &) = delete;
+  NameTable& operator=(const NameTable &) = delete;
+
+  //! Chunk holding an id and the position of the id in the chunk
+  static void locate(Id id, unsigned* chunk, std::size_t* offset);
+
+  //! Chunk c holds 2^(first_chunk_bits + c) strings, so max_chunks chunks
+  //! cover every id
+  static const unsigned first_chunk_bits = 10;
+  static const unsigned max_chunks = 32;
+
+  mutable std::mutex mutex_;       /*!< Guard of ids_ and size_ */
+  //! Stable storage, published with release once allocated (see locate)
+  std::atomic<std::string*> chunks_[max_chunks];
+  Id size_;                        /*!< Number of ids handed out */
+  std::unordered_map<std::string, Id> ids_;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_NAMETABLE_H_
@@ -0,0 +1,223 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @file ObserverEvent.h
+ * Compact records describing one observer notification, and the queue that
+ * carries them from the modules to the observer dispatch thread.
+ */
+#ifndef CORE_OBSERVEREVENT_H_
+#define CORE_OBSERVEREVENT_H_
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include "systemc.h"
+#include "NameTable.h"
+#include "RingBuffer.h"
+#include "TrType.h"
+
+namespace pfp {
+namespace core {
+
+class PFPObject;
+
+/**
+ * One observer notification. Strings are carried as NameTable ids; which
+ * fields are meaningful depends on the kind:
+ *  - Counter*:     module, name (counter), value (new value). The counter
+ *                  name id is stable for the run and identifies the counter
+ *  - Data*:        module, data, name (drop reason, DataDropped only)
+ *  - Thread*:      module (TEU), name (TEC), value (thread id), packet
+ *  - Core*:        module (TEU), name (TEC)
+ * delivery is only set on CounterUpdated events from modules that coalesce
+ * counter updates (see PFPObject::set_counter_coalescing).
+ */
+struct ObserverEvent {
+  enum class Kind : uint8_t {
+    CounterAdded,
+    CounterRemoved,
+    CounterUpdated,
+    DataWritten,
+    DataRead,
+    DataDropped,
+    ThreadBegin,
+    ThreadEnd,
+    ThreadIdle,
+    CoreBusy,
+    CoreIdle
+  };
+
+  /**
+   * Groups of event kinds an observer can subscribe to, combined as a bit
+   * mask in PFPObserver::interests and PFPObject::attach_observer
+   */
+  enum Interest : uint32_t {
+    Counters = 1u << 0,   /*!< CounterAdded, CounterRemoved, CounterUpdated */
+    DataFlow = 1u << 1,   /*!< DataWritten, DataRead */
+    Drops    = 1u << 2,   /*!< DataDropped */
+    Threads  = 1u << 3,   /*!< ThreadBegin, ThreadEnd, ThreadIdle */
+    Cores    = 1u << 4,   /*!< CoreBusy, CoreIdle */
+    //! PFPObserver::histogram_summary, called directly at the end of the run
+    Histograms = 1u << 5,
+    AllEvents = Counters | DataFlow | Drops | Threads | Cores | Histograms,
+    //! Together with Counters: one CounterUpdated per change, even from
+    //! modules that coalesce counter updates (e.g. for watchpoints)
+    ExactCounters = 1u << 6
+  };
+
+  //! Observers an event is delivered to, beyond its interest group
+  enum class Delivery : uint8_t {
+    All,          /*!< Every observer of the interest group */
+    Exact,        /*!< Per-change update, only for ExactCounters observers */
+    Coalesced     /*!< Coalesced update, only for the other observers */
+  };
+
+  /**
+   * Whether an observer with the given interest mask receives an event
+   * @param interests  ObserverEvent::Interest bits of the observer
+   * @return           True if the event is to be delivered
+   */
+  bool delivered_to(uint32_t interests) const {
+    if (!(interests & interest(kind))) {
+      return false;
+    }
+    switch (delivery) {
+      case Delivery::Exact:
+        return (interests & ExactCounters) != 0;
+      case Delivery::Coalesced:
+        return (interests & ExactCounters) == 0;
+      default:
+        return true;
+    }
+  }
+
+  /**
+   * Interest group an event kind belongs to
+   * @param kind  Event kind
+   * @return      Single Interest bit
+   */
+  static uint32_t interest(Kind kind) {
+    switch (kind) {
+      case Kind::CounterAdded:
+      case Kind::CounterRemoved:
+      case Kind::CounterUpdated:
+        return Counters;
+      case Kind::DataWritten:
+      case Kind::DataRead:
+        return DataFlow;
+      case Kind::DataDropped:
+        return Drops;
+      case Kind::ThreadBegin:
+      case Kind::ThreadEnd:
+      case Kind::ThreadIdle:
+        return Threads;
+      default:
+        return Cores;
+    }
+  }
+
+  Kind kind;
+  Delivery delivery;
+  NameTable::Id module;
+  NameTable::Id name;
+  uint64_t value;
+  uint64_t packet;
+  double time;                    /*!< Simulation time of the event */
+  const PFPObject* source;        /*!< Module whose observers are notified */
+  std::shared_ptr<TrType> data;
+};
+
+/**
+ * Queue of ObserverEvents between the simulation and the observer dispatch
+ * thread. Records live in a preallocated ring; the ring only grows if the
+ * dispatcher falls behind by more than its current capacity.
+ */
+class ObserverEventQueue {
+ public:
+  explicit ObserverEventQueue(std::size_t initial_capacity = 4096)
+  : events_(initial_capacity),
+    cond_(sc_gen_unique_name("cond_")) {
+  }
+
+  /**
+   * Push an event, never blocking
+   * @param event  Event to move into the queue
+   */
+  void push(ObserverEvent&& event) {
+    if (events_.full()) {
+      events_.reserve(events_.capacity() * 2);
+    }
+    events_.emplace_back(std::move(event));
+    cond_.notify();
+  }
+
+  /**
+   * Pop the oldest event, waiting until there is one
+   * @return  The oldest event
+   */
+  ObserverEvent pop() {
+    while (events_.empty()) {
+      wait(cond_);
+    }
+    return events_.pop_front();
+  }
+
+  /**
+   * Pop the oldest event if there is one, without blocking
+   * @param event  Output argument
+   * @return       True if an event was popped
+   */
+  bool try_pop(ObserverEvent& event) {
+    if (events_.empty()) {
+      return false;
+    }
+    events_.pop_front(event);
+    return true;
+  }
+
+  std::size_t size() const {
+    return events_.size();
+  }
+
+  bool empty() const {
+    return events_.empty();
+  }
+
+ private:
+  RingBuffer<ObserverEvent> events_;
+  sc_event cond_;   /*!< Event to notify when not empty */
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_OBSERVEREVENT_H_
@@ -45,6 +45,10 @@
 namespace pfp {
 namespace core {
 
+PFPConfig::verbosity PFPConfig::active_verbosity = PFPConfig::normal;
+uint32_t PFPConfig::active_log_levels = 1u << PFPConfig::normal;
+uint32_t PFPConfig::routed_log_levels = 0;
+
 PFPConfig::PFPConfig() {
   if (verbositylevels.size() == verbosity::PROFILE_LEVELS) {
     for (int i = 0; i < verbositylevels.size(); i++) {
@@ -72,11 +76,15 @@ const PFPConfig::verbosity PFPConfig::get_verbose_level() {
 }
 void PFPConfig::set_verbose_level(PFPConfig::verbosity level) {
   verbo = level;
+  active_verbosity = level;
+  active_log_levels = (1u << level) | routed_log_levels;
 }
 void PFPConfig::set_verbose_level(std::string verbosity_level) {
   auto search = verbosity_levels_map.find(verbosity_level);
   if (search != verbosity_levels_map.end()) {
     verbo = static_cast<verbosity>(search->second);
+    active_verbosity = verbo;
+    active_log_levels = (1u << verbo) | routed_log_levels;
   } else {
     std::cerr << "Error: Setting Verbose Level: " << verbosity_level
           << " is invalid" << endl;
@@ -91,6 +99,18 @@ void PFPConfig::set_verbose_level(std::string verbosity_level) {
   }
 }
 
+void PFPConfig::set_routed_log_levels(uint32_t levels) {
+  routed_log_levels = levels;
+  active_log_levels = (1u << active_verbosity) | routed_log_levels;
+}
+
+uint64_t PFPConfig::picoseconds(double time) {
+  static const double ps_per_time_unit =
+        sc_get_default_time_unit().to_seconds() * 1e12;
+  return time > 0 ? static_cast<uint64_t>(time * ps_per_time_unit + 0.5)
+        : 0;
+}
+
 void
 PFPConfig::set_command_line_arg_vector(std::vector<std::string> & args) {
   for (auto & arg : args) {
@@ -123,6 +143,12 @@ std::string & PFPConfig::get_command_line_arg(std::string key) {
   }
 }
 
+const std::string*
+PFPConfig::find_command_line_arg(const std::string& key) const {
+  auto it = argMap.find(key);
+  return it == argMap.end() ? nullptr : &it->second;
+}
+
 void PFPConfig::SetConfigFilePath(std::string path) {
   ConfigFilePath = path;
 }
@@ -135,6 +161,24 @@ void PFPConfig::SetOutputDirPath(std::string path) {
 std::string PFPConfig::getOutputDirPath()const {
   return OutputDirPath;
 }
+void PFPConfig::SetConfigSnapshotPath(std::string path) {
+  ConfigSnapshotPath = path;
+}
+std::string PFPConfig::getConfigSnapshotPath()const {
+  return ConfigSnapshotPath;
+}
+void PFPConfig::set_compile_config_only(bool flag_value) {
+  compile_config_flag = flag_value;
+}
+bool PFPConfig::compile_config_only()const {
+  return compile_config_flag;
+}
+void PFPConfig::set_export_counter_totals(bool flag_value) {
+  export_counter_totals_flag = flag_value;
+}
+bool PFPConfig::export_counter_totals()const {
+  return export_counter_totals_flag;
+}
 void PFPConfig::set_debugger_flag(bool flag_value) {
   debugger_flag = flag_value;
 }
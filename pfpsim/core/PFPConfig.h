@@ -43,6 +43,7 @@
 #ifndef CORE_PFPCONFIG_H_
 #define CORE_PFPCONFIG_H_
 
+#include <cstdint>
 #include <fstream>
 #include <vector>
 #include <string>
@@ -67,8 +68,7 @@ pfp::core::PFPConfig::get().getConfigFilePath()
 #define OUTPUTDIR                   \
 pfp::core::PFPConfig::get().getOutputDirPath()
 #define ISVERBOSITY(level) \
-pfp::core::PFPConfig::get().get_verbose_level() \
-    == pfp::core::PFPConfig::get().verbosity::level
+pfp::core::PFPConfig::active_verbosity == pfp::core::PFPConfig::level
 #define SET_PFP_DEBUGGER_FLAG(debugger_enabled) \
 pfp::core::PFPConfig::get().set_debugger_flag(debugger_enabled)
 #define PFP_DEBUGGER_ENABLED \
@@ -89,6 +89,14 @@ class PFPConfig {
   std::string getConfigFilePath() const;
   void SetOutputDirPath(std::string path);
   std::string getOutputDirPath() const;
+  void SetConfigSnapshotPath(std::string path);
+  std::string getConfigSnapshotPath() const;
+  void set_compile_config_only(bool flag_value);
+  bool compile_config_only() const;
+  //! Export final counter values to OUTPUTDIR/counter_totals.csv; set by
+  //! pfp_main for the runs of a sweep, which collects them
+  void set_export_counter_totals(bool flag_value);
+  bool export_counter_totals() const;
 
   #define VERBOSITY_LEVELS_LINE_MARKER __LINE__
   #define VERBOSITY_LEVELS_FILE_MARKER __FILE__
@@ -115,11 +123,29 @@ class PFPConfig {
    * TODO: Once implemented, change this so that a simulation controller calls simulation complete
    */
   const verbosity get_verbose_level();
+  //! Copy of the verbosity level for log statements, read without get()
+  static verbosity active_verbosity;
+  //! Levels log statements may run at: the bit of active_verbosity plus
+  //! the levels enabled for some modules by log routes (see Logger.h)
+  static uint32_t active_log_levels;
+  static void set_routed_log_levels(uint32_t levels);
+  /**
+   * Convert a duration to picoseconds, the unit of latency histograms
+   * @param time  Duration in SystemC default time units
+   * @return      Duration rounded to picoseconds; 0 if it is not positive
+   */
+  static uint64_t picoseconds(double time);
   void set_verbose_level(PFPConfig::verbosity);
   void set_verbose_level(std::string verbosity_level);
 
   void set_command_line_arg_vector(std::vector<std::string> & v);
   std::string & get_command_line_arg(std::string key);
+  /**
+   * Look a command line argument up without throwing
+   * @param key  Name of the argument
+   * @return     Value of the argument; nullptr if it was not given
+   */
+  const std::string* find_command_line_arg(const std::string& key) const;
   void set_debugger_flag(bool flag_value);
   bool debugger_flag_status();
 
@@ -141,11 +167,15 @@ class PFPConfig {
   sc_mutex pop_guard;
   std::string ConfigFilePath;
   std::string OutputDirPath;
+  std::string ConfigSnapshotPath;
   std::map<std::string, std::string> configMap;
   std::map<std::string, std::string> argMap;
   /* Map that returns the enum from the string*/
   std::map<std::string, uint64_t> verbosity_levels_map;
   bool debugger_flag;
+  bool compile_config_flag = false;
+  bool export_counter_totals_flag = false;
+  static uint32_t routed_log_levels;
 };
 };  // namespace core
 };  // namespace pfp
@@ -41,6 +41,39 @@ namespace core {
 void PFPContext::ensure_top_initialized() {
   if (!top_instance) {
     top_instance = create_top();
+    // The whole hierarchy exists now; index it once
+    ModuleRegistry::get().build(top_instance.get());
+    top_instance->ResolveParameters();
+  }
+}
+
+std::size_t
+PFPContext::at_end_of_simulation(std::function<void(void)> callback,
+      EndPhase phase) {
+  auto handle = next_end_of_simulation_handle_++;
+  end_of_simulation_.emplace(handle, std::make_pair(phase, callback));
+  return handle;
+}
+
+void PFPContext::cancel_end_of_simulation(std::size_t handle) {
+  end_of_simulation_.erase(handle);
+}
+
+void PFPContext::end_of_simulation() {
+  // Swap out first so callbacks can safely (un)register others
+  decltype(end_of_simulation_) callbacks;
+  callbacks.swap(end_of_simulation_);
+  for (auto phase : {EndPhase::Emit, EndPhase::Drain, EndPhase::Finalize}) {
+    if (phase == EndPhase::Drain) {
+      // The observer thread is gone with the simulation; deliver what it
+      // left behind, including the updates of the Emit phase
+      PFPObject::dispatch_queued();
+    }
+    for (auto& callback : callbacks) {
+      if (callback.second.first == phase) {
+        callback.second.second();
+      }
+    }
   }
 }
 
@@ -31,6 +31,10 @@
 #ifndef CORE_PFPCONTEXT_H_
 #define CORE_PFPCONTEXT_H_
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
 #include "PFPObject.h"
 
 namespace pfp {
@@ -42,10 +46,43 @@ class PFPContext {
 
   static PFPContext & get_current_context();
 
+  //! Order in which end of simulation functions run
+  enum class EndPhase {
+    Emit,       /*!< Post updates still held back (e.g. coalesced counters) */
+    Drain,      /*!< Wait for asynchronous consumers of those updates; the
+                     events still queued for observers are dispatched first */
+    Finalize    /*!< Write reports and close outputs */
+  };
+
+  /**
+   * Register a function to run once the simulation has finished, i.e. when
+   * sc_start returns without pfp_pause having been called. Functions run
+   * phase by phase, and in registration order within a phase.
+   * @param callback  Function to call
+   * @param phase     Phase to run the function in
+   * @return          Handle for cancel_end_of_simulation
+   */
+  std::size_t at_end_of_simulation(std::function<void(void)> callback,
+        EndPhase phase = EndPhase::Finalize);
+  /**
+   * Unregister a function added with at_end_of_simulation
+   * @param handle  Handle returned by at_end_of_simulation
+   */
+  void cancel_end_of_simulation(std::size_t handle);
+  /**
+   * Run (and forget) all registered end of simulation functions
+   */
+  void end_of_simulation();
+
  private:
   PFPContext() = default;
 
   std::unique_ptr<PFPObject> top_instance{nullptr};
+  //! End of simulation callbacks with their phase, keyed by registration
+  //! order
+  std::map<std::size_t, std::pair<EndPhase, std::function<void(void)>>>
+        end_of_simulation_;
+  std::size_t next_end_of_simulation_handle_{0};
   static std::unique_ptr<PFPContext> instance;
 };
 
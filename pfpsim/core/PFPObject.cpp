@@ -29,15 +29,46 @@
  */
 
 #include "PFPObject.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
+#include "PFPContext.h"
+#include "StringUtils.h"
 
 #define SIM_ERROR_FATAL -1337
 
 namespace pfp {
 namespace core {
 
-MTQueue<std::function<void(void)>> PFPObject::events_;
+ObserverEventQueue PFPObject::events_;
+bool PFPObject::configuration_frozen_ = false;
+
+namespace {
+//! OUTPUTDIR/histograms.csv, shared by all modules and opened by the first
+//! one to export
+std::ofstream& histogram_export_file() {
+  static std::ofstream file;
+  if (!file.is_open()) {
+    file.open(join_path(OUTPUTDIR, "histograms.csv"));
+    file << "module,histogram,count,mean,min,p50,p90,p99,p999,max"
+         << std::endl;
+  }
+  return file;
+}
+
+//! OUTPUTDIR/counter_totals.csv, shared like histogram_export_file
+std::ofstream& counter_export_file() {
+  static std::ofstream file;
+  if (!file.is_open()) {
+    file.open(join_path(OUTPUTDIR, "counter_totals.csv"));
+    file << "module,counter,value" << std::endl;
+  }
+  return file;
+}
+}  // namespace
 
 PFPObject::PFPObject(const std::string& module_name,
       std::string BaseConfigFile, std::string InstanceConfigFile,
@@ -71,6 +102,21 @@ PFPObject::PFPObject(const PFPObject &other, bool enable_dicp)
 }
 
 
+PFPObject::~PFPObject() {
+  if (histogram_export_handle_ != no_callback) {
+    PFPContext::get_current_context().cancel_end_of_simulation(
+          histogram_export_handle_);
+  }
+  if (counter_flush_handle_ != no_callback) {
+    PFPContext::get_current_context().cancel_end_of_simulation(
+          counter_flush_handle_);
+  }
+  if (counter_export_handle_ != no_callback) {
+    PFPContext::get_current_context().cancel_end_of_simulation(
+          counter_export_handle_);
+  }
+}
+
 PFPObject::PFPObject()
       : GlobalConfigPath("./"),
       dicp_enabled(false),
@@ -81,8 +127,15 @@ PFPObject::PFPObject()
 }
 
 void PFPObject::LoadBaseConfiguration(std::string BaseConfigurationFile) {
+  if (configuration_frozen_) {
+    throw std::runtime_error("Configuration is frozen, cannot load "
+          + BaseConfigurationFile + " for " + module_name());
+  }
   SimulationParameters
         = pfp::core::ConfigurationParameterNode(BaseConfigurationFile);
+  if (parameters_resolved_) {
+    ResolveParameters();
+  }
 
   npulog(std::cout << "Base Configuration: " << On_Red << BaseConfigurationFile
         << txtrst << " for: " << std::endl
@@ -91,6 +144,10 @@ void PFPObject::LoadBaseConfiguration(std::string BaseConfigurationFile) {
 
 void
 PFPObject::LoadInstanceConfiguration(std::string InstanceConfigurationFile) {
+  if (configuration_frozen_) {
+    throw std::runtime_error("Configuration is frozen, cannot load "
+          + InstanceConfigurationFile + " for " + module_name());
+  }
   std::string searchstring = InstanceConfigurationFile;
   // Remove the global config path from the string to check if
   // there is a Instance config file
@@ -110,6 +167,9 @@ PFPObject::LoadInstanceConfiguration(std::string InstanceConfigurationFile) {
           << InstanceParameters.get() << std::endl;)
     npulog(cout << On_Yellow << "Matched and Filled for Instance: " << txtrst
           << endl << FilledParam.get() << endl;)
+    if (parameters_resolved_) {
+      ResolveParameters();
+    }
   }
   npulog(cout << "Instance Config Loaded" << module_name() << endl;)
 }
@@ -117,6 +177,10 @@ PFPObject::LoadInstanceConfiguration(std::string InstanceConfigurationFile) {
 
 pfp::core::ConfigurationParameterNode
 PFPObject::GetParameter(std::string param) {
+  if (auto value = FindResolvedParameter(param)) {
+    return *value;
+  }
+  // Not indexed (yet), or not found: the search below reports the error
   auto result = SimulationParameters.LocalSearch(param);
   if (result == nullptr && module_name_ != "top") {
     return GetParameterfromParent(param, this->GetParent());
@@ -146,32 +210,91 @@ PFPObject::GetParameterfromParent(std::string param, PFPObject* parent) {
   }
 }
 
+void PFPObject::ResolveParameters() {
+  resolved_parameters_.clear();
+  // Same chain as GetParameterfromParent, which stops at top
+  if (parent_ && parent_->parameters_resolved_ && module_name_ != "top") {
+    resolved_parameters_ = parent_->resolved_parameters_;
+  }
+  const ParameterView own = SimulationParameters.view();
+  if (own.json().is_object()) {
+    for (auto it = own.json().cbegin(); it != own.json().cend(); ++it) {
+      resolved_parameters_[it.key()] = own[it.key()];
+    }
+  }
+  parameters_resolved_ = true;
+  for (auto binding : parameter_bindings_) {
+    binding->bind();
+  }
+  for (auto& child : childModules_) {
+    child.second->ResolveParameters();
+  }
+}
+
+const ConfigurationParameterNode::Matrix* PFPObject::FindResolvedParameter(
+      const std::string& param) const {
+  auto it = resolved_parameters_.find(param);
+  return it == resolved_parameters_.end() ? nullptr : &it->second.json();
+}
+
+ParameterView PFPObject::GetParameterView(const std::string& param) {
+  auto it = resolved_parameters_.find(param);
+  if (it != resolved_parameters_.end()) {
+    return it->second;
+  }
+  // Not indexed (yet): search and keep the copy alive in the view
+  return GetParameter(param).view();
+}
+
+void PFPObject::add_parameter_binding(ParameterBinding* binding) {
+  parameter_bindings_.push_back(binding);
+}
+
+void PFPObject::remove_parameter_binding(ParameterBinding* binding) {
+  parameter_bindings_.erase(std::remove(parameter_bindings_.begin(),
+        parameter_bindings_.end(), binding), parameter_bindings_.end());
+}
+
+void PFPObject::FreezeConfiguration() {
+  configuration_frozen_ = true;
+}
+
+bool PFPObject::ConfigurationFrozen() {
+  return configuration_frozen_;
+}
+
 const std::string& PFPObject::module_name() const {
   return module_name_;
 }
 
 const std::string& PFPObject::fully_qualified_module_name() const {
-  if (fully_qualified_module_name_ == "") {
-    std::stringstream ss;
-    bool first = true;
-    auto hierarchy = ModuleHierarchy();
-    auto it  = hierarchy.rbegin();
-    auto end = hierarchy.rend();
-    ++it;  // skip 'top'
-    for (; it != end; ++it) {
-      if (!first) {
-        ss << '.';
-      } else {
-        first = false;
-      }
-      ss << *it;
-    }
-    fully_qualified_module_name_ = ss.str();
+  // Filled in by the ModuleRegistry; before it is built, composed from the
+  // parent's cached name. Top itself is not part of the name.
+  if (fully_qualified_module_name_ == "" && parent_
+        && module_name().find("top") == std::string::npos) {
+    const std::string& parent_name = parent_->fully_qualified_module_name();
+    fully_qualified_module_name_ = parent_name.empty() ? module_name()
+          : parent_name + "." + module_name();
   }
 
   return fully_qualified_module_name_;
 }
 
+NameTable::Id PFPObject::module_name_id() const {
+  if (module_name_id_ == unresolved_name_id) {
+    module_name_id_ = NameTable::get().intern(module_name());
+  }
+  return module_name_id_;
+}
+
+NameTable::Id PFPObject::fully_qualified_module_name_id() const {
+  if (fully_qualified_module_name_id_ == unresolved_name_id) {
+    fully_qualified_module_name_id_
+          = NameTable::get().intern(fully_qualified_module_name());
+  }
+  return fully_qualified_module_name_id_;
+}
+
 PFPObject* PFPObject::GetParent() {
     return parent_;
 }
@@ -179,6 +302,14 @@ PFPObject* PFPObject::GetParent() {
 
 std::vector<std::string> PFPObject::ModuleHierarchy() const {
   std::vector<std::string> hierarchy;
+  if (module_id_ != ModuleRegistry::invalid_id) {
+    const ModuleRegistry& registry = ModuleRegistry::get();
+    for (auto id = module_id_; id != ModuleRegistry::invalid_id;
+          id = registry.parent(id)) {
+      hierarchy.push_back(registry.module(id)->module_name());
+    }
+    return hierarchy;
+  }
   hierarchy.push_back(module_name());
   std::string name = module_name();
   std::size_t found = name.find("top");
@@ -202,139 +333,406 @@ std::vector<std::string> PFPObject::ModuleHierarchy() const {
 
 bool PFPObject::add_counter(const std::string& counter_name,
       std::size_t counter_value) {
-  if (counters_.find(counter_name) == counters_.end()) {
-    counters_.emplace(counter_name, counter_value);
-    notify_counter_added(counter_name, sc_time_stamp().to_default_time_units());
-    return true;
-  } else {
-    return false;
+  return static_cast<bool>(register_counter(counter_name, counter_value));
+}
+
+CounterHandle PFPObject::register_counter(const std::string& counter_name,
+      std::size_t counter_value) {
+  if (counters_.find(counter_name) != counters_.end()) {
+    return CounterHandle();
+  }
+  const std::size_t index = counter_slots_.size();
+  counters_.emplace(counter_name, index);
+  counter_slots_.push_back(CounterSlot{NameTable::get().intern(counter_name),
+        counter_value, true, false});
+  if (counter_export_handle_ == no_callback
+        && PFPConfig::get().export_counter_totals()) {
+    counter_export_handle_ = PFPContext::get_current_context()
+          .at_end_of_simulation([this]() { export_counters(); });
+  }
+  notify_counter_added(counter_name, sc_time_stamp().to_default_time_units());
+  return CounterHandle(index);
+}
+
+CounterHandle PFPObject::counter_handle(
+      const std::string& counter_name) const {
+  auto it = counters_.find(counter_name);
+  if (it == counters_.end()) {
+    return CounterHandle();
   }
+  return CounterHandle(it->second);
 }
 
 bool PFPObject::set_counter(const std::string& counter_name,
       std::size_t counter_value) {
-  try {
-    if (num_counters() == 0) {
-      return false;
-    } else {
-      counters_.at(counter_name) = counter_value;
-      notify_counter_changed(counter_name, counter_value,
-            sc_time_stamp().to_default_time_units());
-      return true;
-    }
-  }
-  catch(std::out_of_range& e) {
+  return set_counter(counter_handle(counter_name), counter_value);
+}
+
+bool PFPObject::set_counter(CounterHandle counter,
+      std::size_t counter_value) {
+  CounterSlot* counter_slot = slot(counter);
+  if (!counter_slot) {
     return false;
   }
+  counter_slot->value = counter_value;
+  counter_changed(*counter_slot);
+  return true;
 }
 
 bool PFPObject::remove_counter(const std::string& counter_name) {
-  try {
-    if (num_counters() == 0) {
-      return false;
-    } else {
-      counters_.erase(counter_name);
-      notify_counter_removed(counter_name,
-            sc_time_stamp().to_default_time_units());
-      return true;
-    }
-  }
-  catch(std::out_of_range &e) {
+  auto it = counters_.find(counter_name);
+  if (it == counters_.end()) {
     return false;
   }
+  counter_slots_[it->second].live = false;
+  counters_.erase(it);
+  notify_counter_removed(counter_name,
+        sc_time_stamp().to_default_time_units());
+  return true;
 }
 
 std::size_t PFPObject::counter_value(const std::string& counter_name) const {
-  return counters_.at(counter_name);
+  return counter_slots_[counters_.at(counter_name)].value;
 }
 
-bool PFPObject::increment_counter(const std::string& counter_name) {
-  try {
-    ++counters_.at(counter_name);
-    notify_counter_changed(counter_name, counters_.at(counter_name),
-          sc_time_stamp().to_default_time_units());
-    return true;
-  }
-  catch(std::out_of_range &e) {
-    return false;
+std::size_t PFPObject::counter_value(CounterHandle counter) const {
+  const CounterSlot* counter_slot = slot(counter);
+  if (!counter_slot) {
+    throw std::out_of_range("PFPObject::counter_value: invalid handle");
   }
+  return counter_slot->value;
+}
+
+bool PFPObject::increment_counter(const std::string& counter_name) {
+  return increment_counter(counter_handle(counter_name));
 }
 
 bool PFPObject::increment_counter(const std::string& counter_name,
       const int incr_amount) {
-  try {
-    counters_.at(counter_name) += incr_amount;
-    notify_counter_changed(counter_name, counters_.at(counter_name),
-          sc_time_stamp().to_default_time_units());
-    return true;
-  }
-  catch(std::out_of_range &e) {
+  return increment_counter(counter_handle(counter_name), incr_amount);
+}
+
+bool PFPObject::increment_counter(CounterHandle counter) {
+  return increment_counter(counter, 1);
+}
+
+bool PFPObject::increment_counter(CounterHandle counter,
+      const int incr_amount) {
+  CounterSlot* counter_slot = slot(counter);
+  if (!counter_slot) {
     return false;
   }
+  counter_slot->value += incr_amount;
+  counter_changed(*counter_slot);
+  return true;
 }
 
 bool PFPObject::decrement_counter(const std::string& counter_name) {
-  try {
-    if (counters_.at(counter_name) == 0) {
-      return false;
-    } else {
-      --counters_.at(counter_name);
-      notify_counter_changed(counter_name, counters_.at(counter_name),
-            sc_time_stamp().to_default_time_units());
-      return true;
-    }
-  }
-  catch(std::out_of_range &e) {
-    return false;
-  }
+  return decrement_counter(counter_handle(counter_name));
 }
 
 bool PFPObject::decrement_counter(const std::string& counter_name,
       const int decr_amount) {
-  try {
-    if (counters_.at(counter_name) == 0) {
-      return false;
-    } else {
-      counters_.at(counter_name) -= decr_amount;
-      notify_counter_changed(counter_name, counters_.at(counter_name),
-            sc_time_stamp().to_default_time_units());
-      return true;
+  return decrement_counter(counter_handle(counter_name), decr_amount);
+}
+
+bool PFPObject::decrement_counter(CounterHandle counter) {
+  return decrement_counter(counter, 1);
+}
+
+bool PFPObject::decrement_counter(CounterHandle counter,
+      const int decr_amount) {
+  CounterSlot* counter_slot = slot(counter);
+  if (!counter_slot || counter_slot->value == 0) {
+    return false;
+  }
+  counter_slot->value -= decr_amount;
+  counter_changed(*counter_slot);
+  return true;
+}
+
+PFPObject::CounterSlot* PFPObject::slot(CounterHandle counter) {
+  if (counter.slot_ >= counter_slots_.size()
+        || !counter_slots_[counter.slot_].live) {
+    return nullptr;
+  }
+  return &counter_slots_[counter.slot_];
+}
+
+const PFPObject::CounterSlot* PFPObject::slot(CounterHandle counter) const {
+  if (counter.slot_ >= counter_slots_.size()
+        || !counter_slots_[counter.slot_].live) {
+    return nullptr;
+  }
+  return &counter_slots_[counter.slot_];
+}
+
+void PFPObject::counter_changed(CounterSlot& counter) {
+  // Through the virtual hook, so that overrides see handle updates too
+  notify_counter_changed(CounterHandle(&counter - counter_slots_.data()),
+        counter.value, sc_time_stamp().to_default_time_units());
+}
+
+void PFPObject::post_counter_update(CounterSlot& counter,
+      std::size_t counter_value, double sim_time) {
+  if (!coalesce_counters_) {
+    post_event(ObserverEvent::Kind::CounterUpdated, module_name_id(),
+          counter.name, counter_value, 0, sim_time);
+    return;
+  }
+  if (wants(ObserverEvent::ExactCounters)) {
+    post_event(ObserverEvent::Kind::CounterUpdated, module_name_id(),
+          counter.name, counter_value, 0, sim_time, nullptr,
+          ObserverEvent::Delivery::Exact);
+  }
+  if (!counter.dirty) {
+    counter.dirty = true;
+    dirty_counters_.push_back(&counter - counter_slots_.data());
+  }
+  if (!flush_pending_) {
+    flush_pending_ = true;
+    flush_event_->notify(coalescing_quantum_);
+  }
+}
+
+void PFPObject::flush_counters() {
+  flush_pending_ = false;
+  const double now = sc_time_stamp().to_default_time_units();
+  for (std::size_t index : dirty_counters_) {
+    CounterSlot& counter = counter_slots_[index];
+    counter.dirty = false;
+    if (counter.live) {
+      post_event(ObserverEvent::Kind::CounterUpdated, module_name_id(),
+            counter.name, counter.value, 0, now, nullptr,
+            ObserverEvent::Delivery::Coalesced);
     }
   }
-  catch(std::out_of_range &e) {
-    return false;
+  dirty_counters_.clear();
+}
+
+void PFPObject::set_counter_coalescing(bool enable, const sc_time& quantum) {
+  for (auto child : childModules_) {
+    child.second->set_counter_coalescing(enable, quantum);
+  }
+  if (coalesce_counters_ && !enable) {
+    flush_counters();
+    if (flush_event_) {
+      flush_event_->cancel();
+    }
   }
+  coalesce_counters_ = enable;
+  coalescing_quantum_ = quantum;
+  if (!enable || flush_event_) {
+    return;
+  }
+  flush_event_.reset(new sc_event(sc_gen_unique_name("counter_flush")));
+  sc_spawn_options options;
+  options.spawn_method();
+  options.dont_initialize();
+  options.set_sensitivity(flush_event_.get());
+  sc_spawn(sc_bind(&PFPObject::flush_counters, this),
+        sc_gen_unique_name("counter_flush"), &options);
+  // Updates still pending when the simulation stops
+  counter_flush_handle_ = PFPContext::get_current_context()
+        .at_end_of_simulation([this]() { flush_counters(); },
+              PFPContext::EndPhase::Emit);
 }
 
 void PFPObject::attach_observer(std::shared_ptr<PFPObserver> observer) {
+  attach_observer(observer, observer->interests());
+}
+
+void PFPObject::attach_observer(std::shared_ptr<PFPObserver> observer,
+      uint32_t interests, const std::string& module_filter) {
   for (auto child : childModules_) {
-    child.second->attach_observer(observer);
+    child.second->attach_observer(observer, interests, module_filter);
+  }
+  if (interests == 0) {
+    return;
+  }
+  if (!module_filter.empty()) {
+    const std::string& name = fully_qualified_module_name();
+    if (name.compare(0, module_filter.size(), module_filter) != 0
+          || (name.size() > module_filter.size()
+              && name[module_filter.size()] != '.')) {
+      return;
+    }
   }
   observers_.push_back(observer);
+  observer_interests_.push_back(interests);
+  interests_ |= interests;
+  dispatch_inline_ = dispatch_inline_ && observer->dispatch_inline();
+}
+
+void PFPObject::notify_counter_changed(CounterHandle counter,
+      std::size_t counter_value, double sim_time) {
+  if (!wants(ObserverEvent::Counters)) {
+    return;
+  }
+  CounterSlot* counter_slot = slot(counter);
+  if (counter_slot) {
+    post_counter_update(*counter_slot, counter_value, sim_time);
+  }
 }
 
 void PFPObject::notify_counter_changed(const std::string& counter_name,
       std::size_t counter_value, double sim_time) {
-  for (auto& each_observer : observers_) {
-    auto func = std::bind(&PFPObserver::counter_updated, each_observer,
-          module_name(), counter_name, counter_value, sim_time);
-    events_.push(func);
+  CounterHandle counter = counter_handle(counter_name);
+  if (counter) {
+    notify_counter_changed(counter, counter_value, sim_time);
+  } else if (wants(ObserverEvent::Counters)) {
+    post_event(ObserverEvent::Kind::CounterUpdated, module_name_id(),
+          NameTable::get().intern(counter_name), counter_value, 0, sim_time);
   }
 }
 
 void PFPObject::notify_counter_added(const std::string& counter_name,
       double sim_time) {
-  for (auto& each_observer : observers_) {
-    each_observer->counter_added(module_name(), counter_name, sim_time);
+  for (std::size_t i = 0; i < observers_.size(); ++i) {
+    if (observer_interests_[i] & ObserverEvent::Counters) {
+      observers_[i]->counter_added(module_name(), counter_name, sim_time);
+    }
   }
 }
 
 void PFPObject::notify_counter_removed(const std::string& counter_name,
       double sim_time)  {
-  for (auto& each_observer : observers_) {
-    auto func = std::bind(&PFPObserver::counter_removed, each_observer,
-          module_name(), counter_name, sim_time);
-    events_.push(func);
+  if (wants(ObserverEvent::Counters)) {
+    post_event(ObserverEvent::Kind::CounterRemoved, module_name_id(),
+          NameTable::get().intern(counter_name), 0, 0, sim_time);
+  }
+}
+
+void PFPObject::engine_ids(const std::string& teu_mod,
+      const std::string& tec_mod, NameTable::Id* teu, NameTable::Id* tec) {
+  if (teu_mod != engine_teu_name_) {
+    engine_teu_ = NameTable::get().intern(teu_mod);
+    engine_teu_name_ = teu_mod;
+  }
+  if (tec_mod != engine_tec_name_) {
+    engine_tec_ = NameTable::get().intern(tec_mod);
+    engine_tec_name_ = tec_mod;
+  }
+  *teu = engine_teu_;
+  *tec = engine_tec_;
+}
+
+void PFPObject::notify_thread_begin(const std::string& teu_mod,
+      const std::string& tec_mod, std::size_t thread_id,
+      std::size_t packet_id, double sim_time) {
+  if (wants(ObserverEvent::Threads)) {
+    NameTable::Id teu, tec;
+    engine_ids(teu_mod, tec_mod, &teu, &tec);
+    notify_thread_begin(teu, tec, thread_id, packet_id, sim_time);
+  }
+}
+
+void PFPObject::notify_thread_end(const std::string& teu_mod,
+      const std::string& tec_mod, std::size_t thread_id,
+      std::size_t packet_id, double sim_time) {
+  if (wants(ObserverEvent::Threads)) {
+    NameTable::Id teu, tec;
+    engine_ids(teu_mod, tec_mod, &teu, &tec);
+    notify_thread_end(teu, tec, thread_id, packet_id, sim_time);
+  }
+}
+
+void PFPObject::notify_thread_idle(const std::string& teu_mod,
+      const std::string& tec_mod, std::size_t thread_id,
+      std::size_t packet_id, double sim_time) {
+  if (wants(ObserverEvent::Threads)) {
+    NameTable::Id teu, tec;
+    engine_ids(teu_mod, tec_mod, &teu, &tec);
+    notify_thread_idle(teu, tec, thread_id, packet_id, sim_time);
+  }
+}
+
+void PFPObject::notify_core_busy(const std::string& teu_mod,
+      const std::string& tec_mod, double sim_time) {
+  if (wants(ObserverEvent::Cores)) {
+    NameTable::Id teu, tec;
+    engine_ids(teu_mod, tec_mod, &teu, &tec);
+    notify_core_busy(teu, tec, sim_time);
+  }
+}
+
+void PFPObject::notify_core_idle(const std::string& teu_mod,
+      const std::string& tec_mod, double sim_time) {
+  if (wants(ObserverEvent::Cores)) {
+    NameTable::Id teu, tec;
+    engine_ids(teu_mod, tec_mod, &teu, &tec);
+    notify_core_idle(teu, tec, sim_time);
+  }
+}
+
+void PFPObject::notify_thread_begin(NameTable::Id teu_mod,
+      NameTable::Id tec_mod, std::size_t thread_id, std::size_t packet_id,
+      double sim_time) {
+  if (wants(ObserverEvent::Threads)) {
+    post_event(ObserverEvent::Kind::ThreadBegin, teu_mod, tec_mod,
+          thread_id, packet_id, sim_time);
+  }
+}
+
+void PFPObject::notify_thread_end(NameTable::Id teu_mod,
+      NameTable::Id tec_mod, std::size_t thread_id, std::size_t packet_id,
+      double sim_time) {
+  if (wants(ObserverEvent::Threads)) {
+    post_event(ObserverEvent::Kind::ThreadEnd, teu_mod, tec_mod,
+          thread_id, packet_id, sim_time);
+  }
+}
+
+void PFPObject::notify_thread_idle(NameTable::Id teu_mod,
+      NameTable::Id tec_mod, std::size_t thread_id, std::size_t packet_id,
+      double sim_time) {
+  if (wants(ObserverEvent::Threads)) {
+    post_event(ObserverEvent::Kind::ThreadIdle, teu_mod, tec_mod,
+          thread_id, packet_id, sim_time);
+  }
+}
+
+void PFPObject::notify_core_busy(NameTable::Id teu_mod,
+      NameTable::Id tec_mod, double sim_time) {
+  if (wants(ObserverEvent::Cores)) {
+    post_event(ObserverEvent::Kind::CoreBusy, teu_mod, tec_mod, 0, 0,
+          sim_time);
+  }
+}
+
+void PFPObject::notify_core_idle(NameTable::Id teu_mod,
+      NameTable::Id tec_mod, double sim_time) {
+  if (wants(ObserverEvent::Cores)) {
+    post_event(ObserverEvent::Kind::CoreIdle, teu_mod, tec_mod, 0, 0,
+          sim_time);
+  }
+}
+
+void PFPObject::post_event(ObserverEvent::Kind kind, NameTable::Id module,
+      NameTable::Id name, uint64_t value, uint64_t packet, double sim_time,
+      std::shared_ptr<TrType> data, ObserverEvent::Delivery delivery) {
+  ObserverEvent event{kind, delivery, module, name, value, packet, sim_time,
+        this, std::move(data)};
+  if (dispatch_inline_) {
+    dispatch(event);
+  } else {
+    events_.push(std::move(event));
+  }
+}
+
+void PFPObject::dispatch(const ObserverEvent& event) {
+  const PFPObject* source = event.source;
+  for (std::size_t i = 0; i < source->observers_.size(); ++i) {
+    if (event.delivered_to(source->observer_interests_[i])) {
+      source->observers_[i]->observe(event);
+    }
+  }
+}
+
+void PFPObject::dispatch_queued() {
+  ObserverEvent event;
+  while (events_.try_pop(event)) {
+    dispatch(event);
   }
 }
 
@@ -342,10 +740,117 @@ std::size_t PFPObject::num_counters() const {
   return counters_.size();
 }
 
+std::vector<std::string> PFPObject::counter_names() const {
+  std::vector<std::string> names;
+  names.reserve(counters_.size());
+  for (auto& each : counters_) {
+    names.push_back(each.first);
+  }
+  return names;
+}
+
+bool PFPObject::has_counter(CounterHandle counter) const {
+  return slot(counter) != nullptr;
+}
+
+Histogram& PFPObject::add_histogram(const std::string& histogram_name,
+      unsigned precision) {
+  auto it = histograms_.find(histogram_name);
+  if (it == histograms_.end()) {
+    it = histograms_.emplace(histogram_name, Histogram(precision)).first;
+  }
+  if (histogram_export_handle_ == no_callback) {
+    histogram_export_handle_ = PFPContext::get_current_context()
+          .at_end_of_simulation([this]() { export_histograms(); });
+  }
+  return it->second;
+}
+
+bool PFPObject::record_value(const std::string& histogram_name,
+      uint64_t value) {
+  auto it = histograms_.find(histogram_name);
+  if (it == histograms_.end()) {
+    return false;
+  }
+  it->second.record(value);
+  return true;
+}
+
+const Histogram& PFPObject::histogram(
+      const std::string& histogram_name) const {
+  return histograms_.at(histogram_name);
+}
+
+Histogram PFPObject::merged_histogram(
+      const std::string& histogram_name) const {
+  auto it = histograms_.find(histogram_name);
+  Histogram merged(it == histograms_.end() ? 6 : it->second.precision());
+  if (it != histograms_.end()) {
+    merged.merge(it->second);
+  }
+  for (auto& child : childModules_) {
+    Histogram from_child = child.second->merged_histogram(histogram_name);
+    if (from_child.count() == 0) {
+      continue;
+    }
+    if (merged.count() == 0) {
+      merged = std::move(from_child);
+    } else {
+      merged.merge(from_child);
+    }
+  }
+  return merged;
+}
+
+std::size_t PFPObject::num_histograms() const {
+  return histograms_.size();
+}
+
+void PFPObject::notify_histogram_summaries(double sim_time) {
+  for (std::size_t i = 0; i < observers_.size(); ++i) {
+    if (observer_interests_[i] & ObserverEvent::Histograms) {
+      for (auto& each : histograms_) {
+        observers_[i]->histogram_summary(fully_qualified_module_name(),
+              each.first, each.second, sim_time);
+      }
+    }
+  }
+}
+
+void PFPObject::export_counters() {
+  const std::string& module = fully_qualified_module_name().empty()
+        ? module_name() : fully_qualified_module_name();
+  std::ofstream& file = counter_export_file();
+  for (auto& each : counters_) {
+    file << csv_field(module) << "," << csv_field(each.first) << ","
+         << counter_slots_[each.second].value << "\n";
+  }
+  file.flush();
+}
+
+void PFPObject::export_histograms() {
+  notify_histogram_summaries(sc_time_stamp().to_default_time_units());
+  std::ofstream& file = histogram_export_file();
+  for (auto& each : histograms_) {
+    const Histogram& h = each.second;
+    file << csv_field(fully_qualified_module_name()) << ","
+         << csv_field(each.first) << "," << h.count() << "," << h.mean()
+         << "," << h.min() << "," << h.value_at_percentile(50) << ","
+         << h.value_at_percentile(90) << "," << h.value_at_percentile(99)
+         << "," << h.value_at_percentile(99.9) << "," << h.max()
+         << std::endl;
+  }
+}
+
 void PFPObject::AddChildModule(std::string module_name,
       PFPObject* module) {
   childModules_[module_name] = module;
 }
 
+const std::map<std::string, PFPObject*>&
+PFPObject::GetChildModules() const {
+  return childModules_;
+}
+
 };  // namespace core
 };  // namespace pfp
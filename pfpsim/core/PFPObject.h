@@ -30,7 +30,9 @@
 
 #ifndef CORE_PFPOBJECT_H_
 #define CORE_PFPOBJECT_H_
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <map>
 #include "systemc.h"  // NOLINT(build/include)
@@ -40,12 +42,27 @@
 #include "LMTQueue.h"
 #include "MTQueue.h"
 #include "PFPObserver.h"
+#include "ObserverEvent.h"
+#include "NameTable.h"
+#include "CounterHandle.h"
+#include "Histogram.h"
+#include "ModuleRegistry.h"
 #include "./promptcolors.h"
 #include "ConfigurationParameters.h"
+#include "Logger.h"
+#include "ParameterBinding.h"
 
 #define GetParam(key) get_param_value(configMap, key)
 #define GetParamI(key) atoi(get_param_value(configMap, key).c_str())
 
+// Parameter lookups through GetParameterView, which does not copy json; the
+// way to move off GetParam/GetParamI. GetParamViewS gives strings as they are
+// and other values in json form. Parameters read repeatedly are better
+// declared as Parameter<T> members (see ParameterBinding.h).
+#define GetParamView(key) GetParameterView(key)
+#define GetParamViewS(key) GetParameterView(key).as_string()
+#define GetParamViewI(key) GetParameterView(key).get<int>()
+
 /*
  * Pre-Processor for NPU Log Levels.
  */
@@ -68,28 +85,25 @@
       cerr << "Error: " << (error_msg) << __FILE__ << ":"                     \
       << __LINE__ << endl; sc_stop(); }
 
-#define LOG_1(STAT)\
-  if (pfp::core::PFPConfig::get().get_verbose_level()                      \
-      != pfp::core::PFPConfig::get().verbosity::minimal                    \
-      && pfp::core::PFPConfig::get().get_verbose_level()                   \
-      == pfp::core::PFPConfig::get().verbosity::debug) {                   \
-      sc_core::sc_time now = sc_time_stamp();                                 \
-    cout << txtgrn << std::fixed << now.to_double()/1000 << " ns "            \
-          << txtrst << "@ " << txtrst << " ";                                 \
-    STAT                                                                      \
-    cout << txtrst;                                                           \
-}
+// Levels outside PFP_LOG_LEVELS compile to nothing; output of enabled
+// statements goes through the Logger (see Logger.h).
+#define LOG_1(STAT)                                                           \
+  if (PFP_LOG_ENABLED(debug)) {                                               \
+    pfp::core::LogStatement pfp_log_statement_(pfp::core::PFPConfig::debug,   \
+          nullptr);                                                           \
+    if (pfp_log_statement_.runs()) {                                          \
+      STAT                                                                    \
+    }                                                                         \
+  }
 
 #define LOG_2(LEVEL, STAT)                                                    \
-    if (pfp::core::PFPConfig::get().get_verbose_level()                    \
-          == pfp::core::PFPConfig::get().verbosity::LEVEL) {               \
-        sc_core::sc_time now = sc_time_stamp();                               \
-    std::string modnametemp = module_name_;                                   \
-    cout << txtgrn << std::fixed << now.to_double()/1000 << " ns "            \
-          << txtrst << "@ " << On_Purple << modnametemp << txtrst << " ";     \
-    STAT                                                                      \
-    cout << txtrst;                                                           \
-    }
+  if (PFP_LOG_ENABLED(LEVEL)) {                                               \
+    pfp::core::LogStatement pfp_log_statement_(pfp::core::PFPConfig::LEVEL,   \
+          this);                                                              \
+    if (pfp_log_statement_.runs()) {                                          \
+      STAT                                                                    \
+    }                                                                         \
+  }
 
 //-------------------------------------------------------------------
 
@@ -108,16 +122,55 @@ class PFPObject {
         std::string InstanceConfigFile = "", PFPObject* parent = 0,
         bool enable_dicp = false);
   PFPObject(const PFPObject &other, bool enable_dicp = false);
-  virtual ~PFPObject() = default;
+  virtual ~PFPObject();
 
   /*--------Configuration of Modules -------------*/
   void LoadBaseConfiguration(std::string);
   void LoadInstanceConfiguration(std::string);
 
   pfp::core::ConfigurationParameterNode GetParameter(std::string param);
+  /**
+   * Find a parameter like GetParameter, without copying its value
+   * @param param  Name of the parameter
+   * @return       View of the value, see ParameterView
+   */
+  ParameterView GetParameterView(const std::string& param);
   pfp::core::ConfigurationParameterNode
   GetParameterfromParent(std::string param, PFPObject* parent);
 
+  /**
+   * Build the flat parameter index of this module and all its submodules:
+   * every parameter reachable through the hierarchical search, with the
+   * values of the closest module already applied. GetParameter and the
+   * hierarchical search of ConfigurationParameterNode then use a single
+   * hash lookup. Called by PFPContext::ensure_top_initialized once the
+   * hierarchy exists, and again for the subtree of a module whose
+   * configuration is reloaded.
+   */
+  void ResolveParameters();
+  /**
+   * Look a parameter up in the index built by ResolveParameters
+   * @param param  Name of the parameter
+   * @return       Value of the parameter; nullptr if it is not reachable
+   *               or the index has not been built
+   */
+  const ConfigurationParameterNode::Matrix* FindResolvedParameter(
+        const std::string& param) const;
+  /**
+   * Forbid any further change of the configuration: loading a
+   * configuration file afterwards throws std::runtime_error. Meant to be
+   * called once elaboration is over, so the parameter index cannot go stale.
+   */
+  static void FreezeConfiguration();
+  static bool ConfigurationFrozen();
+  /**
+   * Register a typed parameter of this module, bound again by
+   * ResolveParameters (see ParameterBinding.h)
+   * @param binding  Parameter member of this module
+   */
+  void add_parameter_binding(ParameterBinding* binding);
+  void remove_parameter_binding(ParameterBinding* binding);
+
   std::vector<std::string> ModuleHierarchy() const;
   /* ----- DICP ----- */
   const bool dicp_enabled;
@@ -125,6 +178,14 @@ class PFPObject {
   /* --- Module ---- */
   const std::string& module_name() const;
   const std::string& fully_qualified_module_name() const;
+  /**
+   * Id of the module in the ModuleRegistry
+   * @return  Module id; ModuleRegistry::invalid_id before the registry is
+   *          built
+   */
+  ModuleRegistry::Id module_id() const {
+    return module_id_;
+  }
   PFPObject* GetParent();
 
   /* --- Observers --- */
@@ -136,6 +197,24 @@ class PFPObject {
    */
   virtual bool add_counter(const std::string& counter_name,
         std::size_t counter_value = 0);
+  /**
+   * Add a counter to the PFPObject and get a handle for O(1) updates. When
+   * PFPConfig::export_counter_totals() is set (as it is for sweep points),
+   * the final values of all counters are exported to
+   * OUTPUTDIR/counter_totals.csv when the simulation ends.
+   * @param counter_name  Name of the counter
+   * @param counter_value  Value of the counter (default: 0)
+   * @return        Handle to the new counter; an invalid handle if the
+   *                counter already exists
+   */
+  CounterHandle register_counter(const std::string& counter_name,
+        std::size_t counter_value = 0);
+  /**
+   * Look up the handle of an existing counter
+   * @param counter_name  Name of the counter
+   * @return        Handle to the counter; invalid if there is no such counter
+   */
+  CounterHandle counter_handle(const std::string& counter_name) const;
   /**
    * Set the value of a counter
    * @param counter_name  Name of the counter
@@ -144,8 +223,10 @@ class PFPObject {
    */
   virtual bool set_counter(const std::string& counter_name,
         std::size_t counter_value);
+  bool set_counter(CounterHandle counter, std::size_t counter_value);
   /**
-   * Remove a counter from the PFPObject
+   * Remove a counter from the PFPObject. Handles to it become stale and
+   * updates through them return false.
    * @param counter_name  Name of the counter
    * @return        True if the counter was removed; false if the PFPObject does not contain the counter
    */
@@ -157,6 +238,7 @@ class PFPObject {
    * @return        Value of the counter
    */
   virtual std::size_t counter_value(const std::string& counter_name) const;
+  std::size_t counter_value(CounterHandle counter) const;
   /**
    * Increment the specified counter
    * @param counter_name  Name of the counter
@@ -165,6 +247,8 @@ class PFPObject {
   virtual bool increment_counter(const std::string& counter_name);
   virtual bool increment_counter(const std::string& counter_name,
         const int incr_amount);
+  bool increment_counter(CounterHandle counter);
+  bool increment_counter(CounterHandle counter, const int incr_amount);
   /**
    * Decrement the specified counter
    * @param counter_name  Name of the counter
@@ -173,13 +257,89 @@ class PFPObject {
   virtual bool decrement_counter(const std::string& counter_name);
   virtual bool decrement_counter(const std::string& counter_name,
         const int decr_amount);
+  bool decrement_counter(CounterHandle counter);
+  bool decrement_counter(CounterHandle counter, const int decr_amount);
   /**
-   * Attach an observer that will be notified when events occur
-   * @param observer  Observer to attach
+   * Coalesce counter updates of this module and all its submodules: a
+   * changed counter is only marked dirty, and observers get at most one
+   * counter_updated per counter per delta cycle (quantum of zero) or per
+   * quantum of simulation time, carrying the latest value. Observers
+   * attached with ObserverEvent::ExactCounters still get every change.
+   * @param enable   False to go back to one update per change
+   * @param quantum  Coalescing period; SC_ZERO_TIME for one delta cycle
+   */
+  void set_counter_coalescing(bool enable,
+        const sc_time& quantum = SC_ZERO_TIME);
+  /**
+   * Add a histogram to the PFPObject. Histograms are summarized to the
+   * observers and exported to OUTPUTDIR/histograms.csv when the simulation
+   * ends.
+   * @param histogram_name  Name of the histogram
+   * @param precision       Significant bits kept per value (see Histogram)
+   * @return        The histogram, which stays valid for the lifetime of the
+   *                PFPObject; recording through it skips the name lookup of
+   *                record_value. An existing histogram is returned as is.
+   */
+  Histogram& add_histogram(const std::string& histogram_name,
+        unsigned precision = 6);
+  /**
+   * Record a value in a histogram
+   * @param histogram_name  Name of the histogram
+   * @param value           Value to record (e.g. a delay in ps, a size)
+   * @return        True if the value was recorded; false if the PFPObject does not contain the histogram
+   */
+  bool record_value(const std::string& histogram_name, uint64_t value);
+  /**
+   * Get a histogram
+   * Note: This will throw a std::out_of_range exception if the histogram does not exist in the PFPObject
+   * @param histogram_name  Name of the histogram
+   * @return        The histogram
+   */
+  const Histogram& histogram(const std::string& histogram_name) const;
+  /**
+   * Merge the histograms of the same name of this PFPObject and all its
+   * submodules, e.g. the queueing delay of every instance of a module
+   * @param histogram_name  Name of the histogram
+   * @return        Merged histogram, empty if no module has the histogram
+   */
+  Histogram merged_histogram(const std::string& histogram_name) const;
+  /**
+   * Get the number of histograms in the PFPObject
+   * @return  Number of histograms
+   */
+  std::size_t num_histograms() const;
+  /**
+   * Notify the attached observers of the content of every histogram
+   * @param sim_time    Simulation time of the summary
+   */
+  void notify_histogram_summaries(double sim_time);
+  /**
+   * Attach an observer that will be notified when events occur, to this
+   * module and all its submodules
+   * @param observer  Observer to attach; its interests() select the events
    */
   virtual void attach_observer(std::shared_ptr<PFPObserver> observer);
   /**
-   * Notify all attached observers when a counter is changed
+   * Attach an observer for a subset of events and modules
+   * @param observer  Observer to attach
+   * @param interests ObserverEvent::Interest bits of the events to deliver
+   * @param module_filter Only attach to modules whose fully qualified name
+   *                  is module_filter or lies below it ("" for all modules)
+   */
+  virtual void attach_observer(std::shared_ptr<PFPObserver> observer,
+        uint32_t interests, const std::string& module_filter = "");
+  /**
+   * Notify all attached observers when a counter is changed. Every counter
+   * update, by name or by handle, goes through this hook.
+   * @param counter  Handle of the counter
+   * @param counter_value  New value of the counter
+   * @param sim_time    Simulation time at which the event occurred
+   */
+  virtual void notify_counter_changed(CounterHandle counter,
+        std::size_t counter_value, double sim_time);
+  /**
+   * Notify all attached observers when a counter is changed; kept for
+   * compatibility, forwards to the CounterHandle overload
    * @param counter_name  Name of the counter
    * @param counter_value  New value of the counter
    * @param sim_time    Simulation time at which the event occurred
@@ -205,12 +365,28 @@ class PFPObject {
    * @return  Number of counters
    */
   virtual std::size_t num_counters() const;
+  /**
+   * Get the names of the counters in the PFPObject
+   * @return  Counter names, in alphabetical order
+   */
+  std::vector<std::string> counter_names() const;
+  /**
+   * Check whether a handle refers to a counter that has not been removed
+   * @param counter  Handle to check
+   * @return  True if the handle can be used to read the counter
+   */
+  bool has_counter(CounterHandle counter) const;
   /**
    * Add a child module to the PFPObject
    * @param module_name name of module
    * @param module pointer to the module
    */
   void AddChildModule(std::string module_name, PFPObject* module);
+  /**
+   * Get the submodules added with AddChildModule
+   * @return  Submodules by name
+   */
+  const std::map<std::string, PFPObject*>& GetChildModules() const;
 
   // TODO(umair) why are all notify_data_* templated when PFPObserver only
   // handles TrType anyway...
@@ -222,10 +398,9 @@ class PFPObject {
   template <typename DATA_TYPE>
   void notify_data_written(const std::shared_ptr<DATA_TYPE> data,
         double sim_time) {
-    for (auto& each_observer : observers_) {
-      auto func = std::bind(&PFPObserver::data_written, each_observer,
-            fully_qualified_module_name(), data, sim_time);
-      events_.push(func);
+    if (wants(ObserverEvent::DataFlow)) {
+      post_event(ObserverEvent::Kind::DataWritten,
+            fully_qualified_module_name_id(), 0, 0, 0, sim_time, data);
     }
   }
   /**
@@ -236,10 +411,9 @@ class PFPObject {
   template <typename DATA_TYPE>
   void notify_data_read(const std::shared_ptr<DATA_TYPE> data,
         double sim_time) {
-    for (auto& each_observer : observers_) {
-      auto func = std::bind(&PFPObserver::data_read, each_observer,
-            fully_qualified_module_name(), data, sim_time);
-      events_.push(func);
+    if (wants(ObserverEvent::DataFlow)) {
+      post_event(ObserverEvent::Kind::DataRead,
+            fully_qualified_module_name_id(), 0, 0, 0, sim_time, data);
     }
   }
   /**
@@ -250,13 +424,66 @@ class PFPObject {
   template <typename DATA_TYPE>
   void notify_data_dropped(const std::shared_ptr<DATA_TYPE> data,
         std::string& drop_reason, double sim_time) {
-    for (auto& each_observer : observers_) {
-      auto func = std::bind(&PFPObserver::data_dropped, each_observer,
-            fully_qualified_module_name(), data, drop_reason, sim_time);
-      events_.push(func);
+    if (wants(ObserverEvent::Drops)) {
+      post_event(ObserverEvent::Kind::DataDropped,
+            fully_qualified_module_name_id(),
+            NameTable::get().intern(drop_reason), 0, 0, sim_time, data);
     }
   }
 
+  /**
+   * Notify all observers that a TEU thread started, ended or went idle
+   * @param teu_mod    TEU running the thread
+   * @param tec_mod    TEC containing the TEU
+   * @param thread_id  ID number of the thread
+   * @param packet_id  ID of the packet being processed
+   * @param sim_time   Simulation time of the event
+   */
+  void notify_thread_begin(const std::string& teu_mod,
+        const std::string& tec_mod, std::size_t thread_id,
+        std::size_t packet_id, double sim_time);
+  void notify_thread_end(const std::string& teu_mod,
+        const std::string& tec_mod, std::size_t thread_id,
+        std::size_t packet_id, double sim_time);
+  void notify_thread_idle(const std::string& teu_mod,
+        const std::string& tec_mod, std::size_t thread_id,
+        std::size_t packet_id, double sim_time);
+  /**
+   * Notify all observers that a core became busy or idle
+   * @param teu_mod    TEU of the core
+   * @param tec_mod    TEC containing the TEU
+   * @param sim_time   Simulation time of the event
+   */
+  void notify_core_busy(const std::string& teu_mod,
+        const std::string& tec_mod, double sim_time);
+  void notify_core_idle(const std::string& teu_mod,
+        const std::string& tec_mod, double sim_time);
+  /**
+   * Same notifications with the TEU and TEC names already interned (see
+   * NameTable::intern), for TEUs that look their ids up once
+   */
+  void notify_thread_begin(NameTable::Id teu_mod, NameTable::Id tec_mod,
+        std::size_t thread_id, std::size_t packet_id, double sim_time);
+  void notify_thread_end(NameTable::Id teu_mod, NameTable::Id tec_mod,
+        std::size_t thread_id, std::size_t packet_id, double sim_time);
+  void notify_thread_idle(NameTable::Id teu_mod, NameTable::Id tec_mod,
+        std::size_t thread_id, std::size_t packet_id, double sim_time);
+  void notify_core_busy(NameTable::Id teu_mod, NameTable::Id tec_mod,
+        double sim_time);
+  void notify_core_idle(NameTable::Id teu_mod, NameTable::Id tec_mod,
+        double sim_time);
+
+  /**
+   * Deliver a queued event to every observer of the module that posted it
+   * @param event  Event popped from events_
+   */
+  static void dispatch(const ObserverEvent& event);
+  /**
+   * Dispatch every event still in events_, e.g. once the simulation has
+   * stopped and the observer thread no longer runs
+   */
+  static void dispatch_queued();
+
   template <typename DATA_TYPE>
   void drop_data(const std::shared_ptr<DATA_TYPE> data,
         std::string drop_reason) {
@@ -266,20 +493,113 @@ class PFPObject {
   }
 
   pfp::core::ConfigurationParameterNode SimulationParameters;
-  static MTQueue<std::function<void(void)>> events_;  /*!< Global event queue */
+  static ObserverEventQueue events_;  /*!< Global event queue */
 
  protected:
+  /**
+   * Queue an event for the observers of this module
+   */
+  void post_event(ObserverEvent::Kind kind, NameTable::Id module,
+        NameTable::Id name, uint64_t value, uint64_t packet, double sim_time,
+        std::shared_ptr<TrType> data = nullptr,
+        ObserverEvent::Delivery delivery = ObserverEvent::Delivery::All);
+  /**
+   * Check whether any attached observer wants an event group; with no
+   * observers this is a single test against zero
+   * @param interest  ObserverEvent::Interest bit
+   */
+  bool wants(uint32_t interest) const {
+    return (interests_ & interest) != 0;
+  }
+  //! Interned module_name()
+  NameTable::Id module_name_id() const;
+  //! Interned fully_qualified_module_name()
+  NameTable::Id fully_qualified_module_name_id() const;
+
   const std::string GlobalConfigPath;
   const std::string module_name_;
   mutable std::string fully_qualified_module_name_;
+  mutable NameTable::Id module_name_id_ = unresolved_name_id;
+  mutable NameTable::Id fully_qualified_module_name_id_ = unresolved_name_id;
+  ModuleRegistry::Id module_id_ = ModuleRegistry::invalid_id;
+  //! Logger state of this module, valid while log_generation_ matches
+  mutable std::size_t log_state_ = 0;
+  mutable unsigned log_generation_ = 0;
   PFPObject* parent_;                /*!< Parent of this PFPObject */
   std::map<std::string, std::string> configMap;  /*!< Configuration Map used >*/
-  //! Store counters and values
+  //! Parameter index built by ResolveParameters; values are views into the
+  //! SimulationParameters of this module or of an ancestor
+  std::unordered_map<std::string, ParameterView> resolved_parameters_;
+  bool parameters_resolved_ = false;
+  //! Typed parameters declared by this module
+  std::vector<ParameterBinding*> parameter_bindings_;
+  static bool configuration_frozen_;
+  //! Name of each counter mapped to its slot in counter_slots_
   std::map<std::string, std::size_t> counters_;
+  //! Histograms by name; map nodes keep references from add_histogram valid
+  std::map<std::string, Histogram> histograms_;
   //! List of observers attached to this PFPObject
   std::vector<std::shared_ptr<PFPObserver>> observers_;
+  //! Interest mask of each entry of observers_
+  std::vector<uint32_t> observer_interests_;
+  //! Union of observer_interests_
+  uint32_t interests_ = 0;
+  //! All observers accept dispatch_inline, so events skip events_
+  bool dispatch_inline_ = true;
+
+  //! Ids of the TEU and TEC names last passed to notify_thread_*/core_*;
+  //! a TEU keeps passing the same names, so they are interned only once
+  void engine_ids(const std::string& teu_mod, const std::string& tec_mod,
+        NameTable::Id* teu, NameTable::Id* tec);
+  std::string engine_teu_name_;
+  std::string engine_tec_name_;
+  NameTable::Id engine_teu_ = 0;
+  NameTable::Id engine_tec_ = 0;
   //! Internal list of submodules
   std::map<std::string, PFPObject*> childModules_;
+
+ private:
+  friend class ModuleRegistry;
+  friend class Logger;
+
+  static const NameTable::Id unresolved_name_id = ~NameTable::Id(0);
+
+  //! Storage behind a CounterHandle
+  struct CounterSlot {
+    NameTable::Id name;   /*!< Interned counter name, as seen by observers */
+    std::size_t value;
+    bool live;            /*!< False once the counter has been removed */
+    bool dirty;           /*!< Changed since the last coalesced update */
+  };
+
+  //! Slot of a handle, or nullptr if the handle is invalid or stale
+  CounterSlot* slot(CounterHandle counter);
+  const CounterSlot* slot(CounterHandle counter) const;
+  void counter_changed(CounterSlot& counter);
+  void post_counter_update(CounterSlot& counter, std::size_t counter_value,
+        double sim_time);
+  void flush_counters();
+  void export_histograms();
+  void export_counters();
+
+  static const std::size_t no_callback = ~std::size_t(0);
+  //! PFPContext::at_end_of_simulation handle of export_histograms
+  std::size_t histogram_export_handle_ = no_callback;
+  //! PFPContext::at_end_of_simulation handle of export_counters
+  std::size_t counter_export_handle_ = no_callback;
+
+  bool coalesce_counters_ = false;
+  sc_time coalescing_quantum_;
+  //! Notified when the first counter becomes dirty; runs flush_counters
+  std::unique_ptr<sc_event> flush_event_;
+  bool flush_pending_ = false;
+  //! Slots with dirty set, in the order they were first changed
+  std::vector<std::size_t> dirty_counters_;
+  //! PFPContext::at_end_of_simulation handle of flush_counters
+  std::size_t counter_flush_handle_ = no_callback;
+
+  //! Counters, indexed by CounterHandle; slots are never reused
+  std::vector<CounterSlot> counter_slots_;
 };
 
 };  // namespace core
@@ -0,0 +1,83 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "PFPObserver.h"
+#include <string>
+
+namespace pfp {
+namespace core {
+
+void PFPObserver::observe(const ObserverEvent& event) {
+  const NameTable& names = NameTable::get();
+  const std::string& module = names.name(event.module);
+  switch (event.kind) {
+    case ObserverEvent::Kind::CounterAdded:
+      counter_added(module, names.name(event.name), event.time);
+      break;
+    case ObserverEvent::Kind::CounterRemoved:
+      counter_removed(module, names.name(event.name), event.time);
+      break;
+    case ObserverEvent::Kind::CounterUpdated:
+      counter_updated(module, names.name(event.name), event.value,
+            event.time);
+      break;
+    case ObserverEvent::Kind::DataWritten:
+      data_written(module, event.data, event.time);
+      break;
+    case ObserverEvent::Kind::DataRead:
+      data_read(module, event.data, event.time);
+      break;
+    case ObserverEvent::Kind::DataDropped:
+      data_dropped(module, event.data, names.name(event.name), event.time);
+      break;
+    case ObserverEvent::Kind::ThreadBegin:
+      thread_begin(module, names.name(event.name), event.value,
+            event.packet, event.time);
+      break;
+    case ObserverEvent::Kind::ThreadEnd:
+      thread_end(module, names.name(event.name), event.value,
+            event.packet, event.time);
+      break;
+    case ObserverEvent::Kind::ThreadIdle:
+      thread_idle(module, names.name(event.name), event.value,
+            event.packet, event.time);
+      break;
+    case ObserverEvent::Kind::CoreBusy:
+      core_busy(module, names.name(event.name), event.time);
+      break;
+    case ObserverEvent::Kind::CoreIdle:
+      core_idle(module, names.name(event.name), event.time);
+      break;
+  }
+}
+
+};  // namespace core
+};  // namespace pfp
@@ -46,6 +46,8 @@
 #include <memory>
 
 #include "TrType.h"
+#include "Histogram.h"
+#include "ObserverEvent.h"
 
 namespace pfp {
 namespace core {
@@ -162,6 +164,48 @@ class PFPObserver {
             const std::string& tec_mod,
             double simulation_time) = 0;
 
+  /**
+   * Function called by the NPU at the end of the simulation for each
+   * histogram of a module (see PFPObject::add_histogram)
+   * @param module_name    Module containing the histogram
+   * @param histogram_name  Name of the histogram
+   * @param histogram      Values recorded during the run
+   * @param simulation_time  Simulation time at which the run ended
+   */
+  virtual void histogram_summary(const std::string& module_name,
+            const std::string& histogram_name,
+            const Histogram& histogram,
+            double simulation_time) {
+  }
+
+  /**
+   * Entry point for every queued notification. The default implementation
+   * switches on the event kind and calls the matching function above;
+   * observers that can work on the compact record directly may override it.
+   * @param event      Event to handle
+   */
+  virtual void observe(const ObserverEvent& event);
+
+  /**
+   * Event groups this observer wants (ObserverEvent::Interest bits). Used by
+   * PFPObject::attach_observer when no explicit mask is given; modules never
+   * queue events that none of their observers want.
+   * @return      Interest mask, all events by default
+   */
+  virtual uint32_t interests() const {
+    return ObserverEvent::AllEvents;
+  }
+
+  /**
+   * Whether observe() may be called directly from the notifying module,
+   * bypassing PFPObject::events_. Only observers whose observe() is cheap
+   * and never waits on the simulation (e.g. AsyncObserver) return true.
+   * @return      False by default
+   */
+  virtual bool dispatch_inline() const {
+    return false;
+  }
+
  protected:
   /**
    * Default destructor
@@ -0,0 +1,86 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "ParameterBinding.h"
+#include <stdexcept>
+#include <string>
+#include "PFPConfig.h"
+#include "PFPObject.h"
+
+namespace pfp {
+namespace core {
+
+ParameterBinding::ParameterBinding(PFPObject* owner, std::string name,
+      Source source)
+: owner_(owner), name_(std::move(name)), source_(source) {
+  owner_->add_parameter_binding(this);
+}
+
+ParameterBinding::~ParameterBinding() {
+  owner_->remove_parameter_binding(this);
+}
+
+void ParameterBinding::bind() {
+  bool found = false;
+  bool converted = false;
+  std::string given;
+  if (source_ == Source::CommandLine) {
+    if (auto arg = PFPConfig::get().find_command_line_arg(name_)) {
+      found = true;
+      given = *arg;
+      converted = assign(*arg);
+    }
+  } else {
+    // Same search as GetParameter, which stops at top
+    for (PFPObject* module = owner_; module && !found;
+          module = module->module_name() == "top" ? nullptr
+                : module->GetParent()) {
+      const ParameterView value = module->SimulationParameters.view()[name_];
+      if (value) {
+        found = true;
+        given = value.json().dump();
+        converted = assign(value.json());
+      }
+    }
+  }
+  if (!found && assign_default()) {
+    return;
+  }
+  if (!converted) {
+    throw std::invalid_argument("Parameter " + name_ + " of "
+          + owner_->module_name() + (found
+                ? ": expected " + std::string(type_name()) + ", got " + given
+                : ": missing, and it has no default value"));
+  }
+}
+
+};  // namespace core
+};  // namespace pfp
@@ -0,0 +1,311 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class ParameterBinding
+ * Typed module parameters, parsed and validated once.
+ * A module declares each parameter it uses as a Parameter<T> member, with
+ * its name and optionally a default value. The value is looked up (in the
+ * configuration of the module and its ancestors, like GetParameter, or on
+ * the command line, like SPARG), converted and checked when the member is
+ * constructed, and again when the configuration is resolved at the end of
+ * elaboration (see PFPObject::ResolveParameters). Reading it afterwards is
+ * a plain member access.
+ *
+ *   class Queue : public pfp::core::PFPObject {
+ *     pfp::core::Parameter<int> depth_{this, "depth", 64};
+ *     pfp::core::Parameter<double> rate_{this, "rate",
+ *           pfp::core::ParameterBinding::Source::CommandLine};
+ *     ...
+ *     if (size < depth_) ...
+ *   };
+ *
+ * A missing parameter without default, or a value that is not of the
+ * declared type (a json string holding a number is accepted for a number,
+ * as a command line argument is), throws std::invalid_argument naming the
+ * module and the parameter; integers out of the range of T are rejected
+ * instead of wrapping around.
+ */
+#ifndef CORE_PARAMETERBINDING_H_
+#define CORE_PARAMETERBINDING_H_
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "json.hpp"
+
+namespace pfp {
+namespace core {
+
+class PFPObject;
+
+//! Conversion of a configuration value or command line argument to T
+template <typename T, typename Enable = void>
+struct ParameterTraits;
+
+template <>
+struct ParameterTraits<bool> {
+  static const char* type_name() {
+    return "boolean";
+  }
+  static bool from_json(const nlohmann::json& value, bool* result) {
+    if (value.is_boolean()) {
+      *result = value.get<bool>();
+      return true;
+    }
+    return value.is_string() && from_string(value.get<std::string>(), result);
+  }
+  static bool from_string(const std::string& text, bool* result) {
+    if (text == "true" || text == "1") {
+      *result = true;
+    } else if (text == "false" || text == "0") {
+      *result = false;
+    } else {
+      return false;
+    }
+    return true;
+  }
+};
+
+template <typename T>
+struct ParameterTraits<T, typename std::enable_if<std::is_integral<T>::value
+      && !std::is_same<T, bool>::value>::type> {
+  static const char* type_name() {
+    return std::is_signed<T>::value ? "integer" : "unsigned integer";
+  }
+  static bool from_json(const nlohmann::json& value, T* result) {
+    if (value.is_number_unsigned()) {
+      return assign_unsigned(value.get<uint64_t>(), result);
+    }
+    if (value.is_number_integer()) {
+      return assign_signed(value.get<int64_t>(), result);
+    }
+    return value.is_string() && from_string(value.get<std::string>(), result);
+  }
+  static bool from_string(const std::string& text, T* result) {
+    if (text.empty() || text[0] == ' ') {
+      return false;
+    }
+    char* end;
+    errno = 0;
+    if (text[0] == '-') {
+      const long long number = std::strtoll(text.c_str(), &end, 10);
+      return errno == 0 && *end == '\0' && assign_signed(number, result);
+    }
+    const unsigned long long number = std::strtoull(text.c_str(), &end, 10);
+    return errno == 0 && *end == '\0' && assign_unsigned(number, result);
+  }
+
+ private:
+  static bool assign_signed(int64_t number, T* result) {
+    if (number < 0 ? (!std::is_signed<T>::value
+          || number < static_cast<int64_t>(std::numeric_limits<T>::min()))
+          : !assign_unsigned(static_cast<uint64_t>(number), result)) {
+      return false;
+    }
+    *result = static_cast<T>(number);
+    return true;
+  }
+  static bool assign_unsigned(uint64_t number, T* result) {
+    if (number > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+      return false;
+    }
+    *result = static_cast<T>(number);
+    return true;
+  }
+};
+
+template <typename T>
+struct ParameterTraits<T, typename std::enable_if<
+      std::is_floating_point<T>::value>::type> {
+  static const char* type_name() {
+    return "number";
+  }
+  static bool from_json(const nlohmann::json& value, T* result) {
+    if (value.is_number()) {
+      *result = value.get<T>();
+      return true;
+    }
+    return value.is_string() && from_string(value.get<std::string>(), result);
+  }
+  static bool from_string(const std::string& text, T* result) {
+    if (text.empty() || text[0] == ' ') {
+      return false;
+    }
+    char* end;
+    errno = 0;
+    const double number = std::strtod(text.c_str(), &end);
+    if (errno != 0 || *end != '\0') {
+      return false;
+    }
+    *result = static_cast<T>(number);
+    return true;
+  }
+};
+
+template <>
+struct ParameterTraits<std::string> {
+  static const char* type_name() {
+    return "string";
+  }
+  static bool from_json(const nlohmann::json& value, std::string* result) {
+    if (value.is_string()) {
+      *result = value.get<std::string>();
+      return true;
+    }
+    return false;
+  }
+  static bool from_string(const std::string& text, std::string* result) {
+    *result = text;
+    return true;
+  }
+};
+
+class ParameterBinding {
+ public:
+  //! Where the value of a parameter comes from
+  enum class Source {
+    Configuration,  /*!< Configuration of the module or an ancestor */
+    CommandLine     /*!< -X name value (see SPARG) */
+  };
+
+  ParameterBinding(const ParameterBinding&) = delete;
+  ParameterBinding& operator=(const ParameterBinding&) = delete;
+  virtual ~ParameterBinding();
+
+  /**
+   * Look the value up again and convert it
+   * @throws std::invalid_argument if it is missing without a default or is
+   *         not of the declared type
+   */
+  void bind();
+
+  //! Name of the parameter
+  const std::string& name() const {
+    return name_;
+  }
+
+ protected:
+  /**
+   * Register a binding with its module; the derived class binds it
+   * @param owner   Module declaring the parameter
+   * @param name    Name of the parameter
+   * @param source  Where the value comes from
+   */
+  ParameterBinding(PFPObject* owner, std::string name, Source source);
+
+  //! Convert a configuration value; false if it has the wrong type
+  virtual bool assign(const nlohmann::json& value) = 0;
+  //! Convert a command line argument; false if it has the wrong type
+  virtual bool assign(const std::string& text) = 0;
+  //! Use the default value; false if there is none
+  virtual bool assign_default() = 0;
+  virtual const char* type_name() const = 0;
+
+ private:
+  PFPObject* const owner_;
+  const std::string name_;
+  const Source source_;
+};
+
+template <typename T>
+class Parameter : public ParameterBinding {
+ public:
+  /**
+   * Declare a required parameter
+   * @param owner   Module declaring the parameter, usually this
+   * @param name    Name of the parameter
+   * @param source  Where the value comes from
+   */
+  Parameter(PFPObject* owner, std::string name,
+        Source source = Source::Configuration)
+  : ParameterBinding(owner, std::move(name), source), value_(),
+    has_default_(false) {
+    bind();
+  }
+
+  /**
+   * Declare a parameter with a default value
+   * @param owner          Module declaring the parameter, usually this
+   * @param name           Name of the parameter
+   * @param default_value  Value used when the parameter is not set
+   * @param source         Where the value comes from
+   */
+  Parameter(PFPObject* owner, std::string name, T default_value,
+        Source source = Source::Configuration)
+  : ParameterBinding(owner, std::move(name), source),
+    value_(default_value), default_(std::move(default_value)),
+    has_default_(true) {
+    bind();
+  }
+
+  const T& get() const {
+    return value_;
+  }
+
+  operator const T&() const {
+    return value_;
+  }
+
+ protected:
+  bool assign(const nlohmann::json& value) override {
+    return ParameterTraits<T>::from_json(value, &value_);
+  }
+
+  bool assign(const std::string& text) override {
+    return ParameterTraits<T>::from_string(text, &value_);
+  }
+
+  bool assign_default() override {
+    if (has_default_) {
+      value_ = default_;
+    }
+    return has_default_;
+  }
+
+  const char* type_name() const override {
+    return ParameterTraits<T>::type_name();
+  }
+
+ private:
+  T value_;
+  T default_;
+  const bool has_default_;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_PARAMETERBINDING_H_
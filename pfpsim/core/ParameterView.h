@@ -0,0 +1,178 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class ParameterView
+ * Read-only handle on a value inside a parsed configuration document.
+ * Indexing a view and reading it with get<T>() never copies json: a view
+ * is a pointer to the value plus a reference on the (immutable, see
+ * ConfigurationCache) document holding it, which keeps the value alive.
+ * Looking up a missing key or position gives an invalid view; reading an
+ * invalid view throws std::out_of_range naming the missing key.
+ *
+ *   auto table = GetParameterView("routes");
+ *   for (std::size_t i = 0; i < table.size(); ++i) {
+ *     add_route(table[i]["prefix"].get<std::string>(),
+ *           table[i]["port"].get<int>());
+ *   }
+ */
+#ifndef CORE_PARAMETERVIEW_H_
+#define CORE_PARAMETERVIEW_H_
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "json.hpp"
+
+namespace pfp {
+namespace core {
+
+class ParameterView {
+ public:
+  typedef nlohmann::json Matrix;
+
+  //! Invalid view
+  ParameterView() : value_(nullptr) {
+  }
+
+  /**
+   * View of a whole document
+   * @param document  Document to view
+   */
+  explicit ParameterView(std::shared_ptr<const Matrix> document)
+  : document_(std::move(document)), value_(document_.get()) {
+  }
+
+  /**
+   * View of a value inside a document
+   * @param document  Document holding the value
+   * @param value     Value to view; nullptr for an invalid view
+   * @param path      Key or position of a missing value, for errors
+   */
+  ParameterView(std::shared_ptr<const Matrix> document, const Matrix* value,
+        std::string path)
+  : document_(std::move(document)), value_(value), path_(std::move(path)) {
+  }
+
+  //! Whether the viewed value exists
+  bool valid() const {
+    return value_ != nullptr;
+  }
+
+  explicit operator bool() const {
+    return valid();
+  }
+
+  /**
+   * Member of an object
+   * @param key  Key of the member
+   * @return     View of the member; invalid if there is no such member
+   */
+  ParameterView operator[](const std::string& key) const {
+    const Matrix* member = nullptr;
+    if (value_ && value_->is_object()) {
+      auto it = value_->find(key);
+      if (it != value_->end()) {
+        member = &it.value();
+      }
+    }
+    return ParameterView(document_, member, member ? std::string()
+          : path_.empty() ? key : path_ + "." + key);
+  }
+
+  ParameterView operator[](const char* key) const {
+    return (*this)[std::string(key)];
+  }
+
+  /**
+   * Element of an array
+   * @param position  Index of the element
+   * @return          View of the element; invalid if out of range
+   */
+  ParameterView operator[](std::size_t position) const {
+    const Matrix* element = nullptr;
+    if (value_ && value_->is_array() && position < value_->size()) {
+      element = &(*value_)[position];
+    }
+    return ParameterView(document_, element, element ? std::string()
+          : path_ + "[" + std::to_string(position) + "]");
+  }
+
+  ParameterView operator[](int position) const {
+    return (*this)[static_cast<std::size_t>(position)];
+  }
+
+  /**
+   * Convert the viewed value
+   * @return  Value as a T
+   */
+  template <typename T>
+  T get() const {
+    return json().get<T>();
+  }
+
+  /**
+   * Viewed value as a string: strings as they are, other values in their
+   * json form (e.g. 42, true)
+   */
+  std::string as_string() const {
+    const Matrix& value = json();
+    return value.is_string() ? value.get<std::string>() : value.dump();
+  }
+
+  //! Number of members or elements; 0 for an invalid view
+  std::size_t size() const {
+    return value_ ? value_->size() : 0;
+  }
+
+  /**
+   * The viewed json value itself
+   * @return  Reference valid for as long as the view (or a copy) exists
+   */
+  const Matrix& json() const {
+    if (!value_) {
+      throw std::out_of_range("Configuration parameter not found: " + path_);
+    }
+    return *value_;
+  }
+
+ private:
+  std::shared_ptr<const Matrix> document_;  /*!< Keeps value_ alive */
+  const Matrix* value_;
+  //! Key or position of a missing value, for errors; empty when valid
+  std::string path_;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_PARAMETERVIEW_H_
@@ -0,0 +1,106 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "QueueStats.h"
+#include <iostream>
+#include <string>
+#include "PFPContext.h"
+
+namespace pfp {
+namespace core {
+
+QueueStats::QueueStats()
+      : created_(sc_time_stamp()), last_change_(sc_time_stamp()),
+      occupancy_area_(0), occupancy_(0), high_water_mark_(0),
+      enqueued_(0), dequeued_(0), dropped_(0), stamps_(64),
+      report_registered_(false), report_handle_(0) {
+}
+
+QueueStats::~QueueStats() {
+  if (report_registered_) {
+    PFPContext::get_current_context().cancel_end_of_simulation(
+          report_handle_);
+  }
+}
+
+double QueueStats::elapsed() const {
+  return (sc_time_stamp() - created_).to_seconds();
+}
+
+double QueueStats::average_occupancy() const {
+  const double span = elapsed();
+  if (span <= 0) {
+    return occupancy_;
+  }
+  const double area = occupancy_area_
+        + occupancy_ * (sc_time_stamp() - last_change_).to_seconds();
+  return area / span;
+}
+
+double QueueStats::enqueue_rate() const {
+  const double span = elapsed();
+  return span > 0 ? enqueued_ / span : 0;
+}
+
+double QueueStats::dequeue_rate() const {
+  const double span = elapsed();
+  return span > 0 ? dequeued_ / span : 0;
+}
+
+void QueueStats::report(std::ostream& os, const std::string& name) const {
+  os << "Queue " << name << ":" << std::endl
+     << "  enqueued:          " << enqueued_ << " ("
+     << enqueue_rate() << "/s)" << std::endl
+     << "  dequeued:          " << dequeued_ << " ("
+     << dequeue_rate() << "/s)" << std::endl
+     << "  dropped:           " << dropped_ << std::endl
+     << "  occupancy:         " << occupancy_ << std::endl
+     << "  high water mark:   " << high_water_mark_ << std::endl
+     << "  average occupancy: " << average_occupancy() << std::endl
+     << "  sojourn time (ps): ";
+  sojourn_time_.summary(os);
+  os << std::endl;
+}
+
+void QueueStats::report_at_end_of_simulation(const std::string& name) {
+  auto& context = PFPContext::get_current_context();
+  if (report_registered_) {
+    context.cancel_end_of_simulation(report_handle_);
+  }
+  report_handle_ = context.at_end_of_simulation([this, name]() {
+    report_registered_ = false;
+    report(std::cout, name);
+  });
+  report_registered_ = true;
+}
+
+};  // namespace core
+};  // namespace pfp
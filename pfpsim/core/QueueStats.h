@@ -0,0 +1,191 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @file QueueStats.h
+ * Instrumentation policies for MTQueue and LMTQueue.
+ *
+ * The queue templates take the policy as their last template parameter and
+ * call on_push/on_pop/on_drop with the new occupancy under their guard.
+ * NoQueueStats is the default and compiles away entirely; QueueStats records
+ * the high-water mark, time-weighted average occupancy, enqueue/dequeue
+ * rates, head drops and a sojourn-time histogram:
+ *
+ *   LMTQueue<std::shared_ptr<Packet>, 64, pfp::core::QueueStats> q;
+ *   q.stats().report_at_end_of_simulation("top.ingress.q");
+ */
+#ifndef CORE_QUEUESTATS_H_
+#define CORE_QUEUESTATS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "systemc.h"
+#include "Histogram.h"
+#include "PFPConfig.h"
+#include "RingBuffer.h"
+
+namespace pfp {
+namespace core {
+
+/**
+ * Queue instrumentation policy which records nothing
+ */
+class NoQueueStats {
+ public:
+  void on_push(std::size_t occupancy) {}
+  void on_pop(std::size_t occupancy) {}
+  void on_drop(std::size_t occupancy) {}
+};
+
+/**
+ * Queue instrumentation policy which records occupancy and sojourn times
+ */
+class QueueStats {
+ public:
+  QueueStats();
+  ~QueueStats();
+
+  QueueStats(const QueueStats&) = delete;
+  QueueStats& operator=(const QueueStats&) = delete;
+
+  /**
+   * Called by the queue after an item was pushed
+   * @param occupancy  Number of items in the queue after the push
+   */
+  void on_push(std::size_t occupancy) {
+    const sc_time& now = sc_time_stamp();
+    advance(now);
+    occupancy_ = occupancy;
+    if (occupancy > high_water_mark_) {
+      high_water_mark_ = occupancy;
+    }
+    ++enqueued_;
+    if (stamps_.full()) {
+      stamps_.reserve(stamps_.capacity() * 2);
+    }
+    stamps_.emplace_back(now);
+  }
+
+  /**
+   * Called by the queue after an item was popped
+   * @param occupancy  Number of items in the queue after the pop
+   */
+  void on_pop(std::size_t occupancy) {
+    const sc_time& now = sc_time_stamp();
+    advance(now);
+    occupancy_ = occupancy;
+    ++dequeued_;
+    if (!stamps_.empty()) {
+      sojourn_time_.record(PFPConfig::picoseconds(
+            (now - stamps_.pop_front()).to_default_time_units()));
+    }
+  }
+
+  /**
+   * Called by the queue after a queued item was dropped (e.g. a head drop);
+   * the item is not counted as dequeued and has no sojourn time
+   * @param occupancy  Number of items in the queue after the drop
+   */
+  void on_drop(std::size_t occupancy) {
+    advance(sc_time_stamp());
+    occupancy_ = occupancy;
+    ++dropped_;
+    if (!stamps_.empty()) {
+      stamps_.drop_front();
+    }
+  }
+
+  //! Largest number of items the queue has held
+  std::size_t high_water_mark() const { return high_water_mark_; }
+  //! Number of items currently in the queue
+  std::size_t occupancy() const { return occupancy_; }
+  //! Total number of items pushed
+  uint64_t enqueued() const { return enqueued_; }
+  //! Total number of items popped
+  uint64_t dequeued() const { return dequeued_; }
+  //! Total number of queued items dropped
+  uint64_t dropped() const { return dropped_; }
+  /**
+   * Occupancy averaged over simulation time since the queue was created
+   */
+  double average_occupancy() const;
+  /**
+   * Items pushed per second of simulation time
+   */
+  double enqueue_rate() const;
+  /**
+   * Items popped per second of simulation time
+   */
+  double dequeue_rate() const;
+  /**
+   * Time each popped item spent in the queue, in picoseconds
+   */
+  const Histogram& sojourn_time() const { return sojourn_time_; }
+
+  /**
+   * Write all statistics to a stream
+   * @param os    Stream to write to
+   * @param name  Name used to identify the queue in the report
+   */
+  void report(std::ostream& os, const std::string& name) const;
+  /**
+   * Write the report to std::cout when the simulation finishes
+   * @param name  Name used to identify the queue in the report
+   */
+  void report_at_end_of_simulation(const std::string& name);
+
+ private:
+  void advance(const sc_time& now) {
+    occupancy_area_ += occupancy_ * (now - last_change_).to_seconds();
+    last_change_ = now;
+  }
+  double elapsed() const;
+
+  sc_time created_;              /*!< Simulation time at construction */
+  sc_time last_change_;          /*!< Time of the last push or pop */
+  double occupancy_area_;        /*!< Integral of occupancy over time */
+  std::size_t occupancy_;
+  std::size_t high_water_mark_;
+  uint64_t enqueued_;
+  uint64_t dequeued_;
+  uint64_t dropped_;
+  RingBuffer<sc_time> stamps_;   /*!< Push time of each queued item */
+  Histogram sojourn_time_;
+  bool report_registered_;
+  std::size_t report_handle_;    /*!< End of simulation callback handle */
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_QUEUESTATS_H_
@@ -0,0 +1,197 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/**
+ * @class RingBuffer
+ * Contiguous FIFO storage with a power-of-two number of slots.
+ * The slots are allocated once when the buffer is constructed; elements are
+ * constructed in place on push and moved out on pop, so steady-state use
+ * never touches the heap. RingBuffer does no locking of its own, the
+ * MTQueue family wraps it with the SystemC primitives.
+ */
+#ifndef CORE_RINGBUFFER_H_
+#define CORE_RINGBUFFER_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace pfp {
+namespace core {
+
+template <typename T>
+class RingBuffer {
+ public:
+  /**
+   * Construct a RingBuffer
+   * @param min_capacity  Number of elements the buffer must be able to hold,
+   *                      rounded up to the next power of two
+   */
+  explicit RingBuffer(std::size_t min_capacity)
+  : slots_(new Slot[round_up_pow2(min_capacity)]),
+    mask_(round_up_pow2(min_capacity) - 1), head_(0), tail_(0) {
+  }
+
+  RingBuffer(const RingBuffer&) = delete;
+  RingBuffer& operator=(const RingBuffer&) = delete;
+
+  ~RingBuffer() {
+    clear();
+  }
+
+  /**
+   * Construct an element in place at the back of the buffer.
+   * The caller is responsible for checking full() beforehand.
+   * @param args  Constructor arguments for T
+   */
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
+    new (slot(tail_)) T(std::forward<Args>(args)...);
+    ++tail_;
+  }
+
+  /**
+   * Access the oldest element in the buffer
+   * @return  Reference to the front element
+   */
+  T& front() {
+    return *slot(head_);
+  }
+
+  const T& front() const {
+    return *slot(head_);
+  }
+
+  /**
+   * Remove the oldest element from the buffer and return it by move
+   * @return  The front element
+   */
+  T pop_front() {
+    T item(std::move(*slot(head_)));
+    drop_front();
+    return item;
+  }
+
+  /**
+   * Remove the oldest element from the buffer, moving it into item
+   * @param item  Output argument
+   */
+  void pop_front(T& item) {
+    item = std::move(*slot(head_));
+    drop_front();
+  }
+
+  /**
+   * Destroy the oldest element in the buffer without returning it
+   */
+  void drop_front() {
+    slot(head_)->~T();
+    ++head_;
+  }
+
+  /**
+   * Grow the buffer so that it can hold at least min_capacity elements.
+   * This reallocates, and is meant for the rare case where a buffer has to
+   * outgrow its initial sizing; it never shrinks the buffer.
+   * @param min_capacity  Required number of elements
+   */
+  void reserve(std::size_t min_capacity) {
+    if (min_capacity <= capacity()) {
+      return;
+    }
+    const std::size_t new_capacity = round_up_pow2(min_capacity);
+    std::unique_ptr<Slot[]> new_slots(new Slot[new_capacity]);
+    const std::size_t count = size();
+    for (std::size_t i = 0; i < count; ++i) {
+      new (&new_slots[i]) T(std::move(*slot(head_)));
+      drop_front();
+    }
+    slots_.swap(new_slots);
+    mask_ = new_capacity - 1;
+    head_ = 0;
+    tail_ = count;
+  }
+
+  /**
+   * Destroy all elements in the buffer
+   */
+  void clear() {
+    while (!empty()) {
+      drop_front();
+    }
+  }
+
+  std::size_t size() const {
+    return tail_ - head_;
+  }
+
+  std::size_t capacity() const {
+    return mask_ + 1;
+  }
+
+  bool empty() const {
+    return head_ == tail_;
+  }
+
+  bool full() const {
+    return size() == capacity();
+  }
+
+ private:
+  typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Slot;
+
+  static std::size_t round_up_pow2(std::size_t n) {
+    std::size_t capacity = 1;
+    while (capacity < n) {
+      capacity <<= 1;
+    }
+    return capacity;
+  }
+
+  T* slot(std::size_t index) {
+    return reinterpret_cast<T*>(&slots_[index & mask_]);
+  }
+
+  const T* slot(std::size_t index) const {
+    return reinterpret_cast<const T*>(&slots_[index & mask_]);
+  }
+
+  std::unique_ptr<Slot[]> slots_;  /*!< Preallocated element storage */
+  std::size_t mask_;               /*!< capacity - 1 */
+  //! Free-running read and write positions, wrapped through mask_
+  std::size_t head_, tail_;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_RINGBUFFER_H_
@@ -0,0 +1,174 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "SchedulingPolicy.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace pfp {
+namespace core {
+
+std::size_t StrictPriority::select(const std::vector<std::size_t>& head_cost) {
+  std::size_t cls = 0;
+  while (head_cost[cls] == 0) {
+    ++cls;
+  }
+  return cls;
+}
+
+WeightedRoundRobin::WeightedRoundRobin(std::vector<std::size_t> weights)
+      : weights_(weights), current_(0), credit_(0) {
+}
+
+void WeightedRoundRobin::configure(
+      const std::vector<std::size_t>& class_capacity) {
+  const std::size_t num_classes = class_capacity.size();
+  if (num_classes == 0) {
+    throw std::invalid_argument("WeightedRoundRobin needs at least one class");
+  }
+  weights_.resize(num_classes, 1);
+  for (auto& weight : weights_) {
+    weight = std::max<std::size_t>(weight, 1);
+  }
+  current_ = 0;
+  credit_ = weights_[0];
+}
+
+std::size_t
+WeightedRoundRobin::select(const std::vector<std::size_t>& head_cost) {
+  if (credit_ == 0 || head_cost[current_] == 0) {
+    do {
+      current_ = (current_ + 1) % weights_.size();
+    } while (head_cost[current_] == 0);
+    credit_ = weights_[current_];
+  }
+  --credit_;
+  return current_;
+}
+
+DeficitRoundRobin::DeficitRoundRobin(std::vector<std::size_t> quanta)
+      : quanta_(quanta), current_(0), fresh_visit_(true) {
+}
+
+void DeficitRoundRobin::configure(
+      const std::vector<std::size_t>& class_capacity) {
+  const std::size_t num_classes = class_capacity.size();
+  quanta_.resize(num_classes, 1);
+  for (auto& quantum : quanta_) {
+    quantum = std::max<std::size_t>(quantum, 1);
+  }
+  deficit_.assign(num_classes, 0);
+  current_ = 0;
+  fresh_visit_ = true;
+}
+
+std::size_t
+DeficitRoundRobin::select(const std::vector<std::size_t>& head_cost) {
+  while (true) {
+    if (head_cost[current_] == 0) {
+      // Idle classes do not bank credit
+      deficit_[current_] = 0;
+    } else {
+      if (fresh_visit_) {
+        deficit_[current_] += quanta_[current_];
+        fresh_visit_ = false;
+      }
+      if (head_cost[current_] <= deficit_[current_]) {
+        return current_;
+      }
+    }
+    current_ = (current_ + 1) % quanta_.size();
+    fresh_visit_ = true;
+  }
+}
+
+void DeficitRoundRobin::dequeued(std::size_t cls, std::size_t cost) {
+  deficit_[cls] -= std::min(cost, deficit_[cls]);
+}
+
+WeightedFairQueueing::WeightedFairQueueing(std::vector<double> weights)
+      : weights_(weights), virtual_time_(0) {
+}
+
+void WeightedFairQueueing::configure(
+      const std::vector<std::size_t>& class_capacity) {
+  const std::size_t num_classes = class_capacity.size();
+  weights_.resize(num_classes, 1);
+  for (auto& weight : weights_) {
+    if (weight <= 0) {
+      weight = 1;
+    }
+  }
+  last_finish_.assign(num_classes, 0);
+  capacity_ = class_capacity;
+  base_.assign(num_classes, 0);
+  std::size_t total = 0;
+  for (std::size_t cls = 0; cls < num_classes; ++cls) {
+    base_[cls] = total;
+    total += capacity_[cls];
+  }
+  finish_.assign(total, 0);
+  head_.assign(num_classes, 0);
+  count_.assign(num_classes, 0);
+  virtual_time_ = 0;
+}
+
+void WeightedFairQueueing::enqueued(std::size_t cls, std::size_t cost) {
+  const double start = std::max(virtual_time_, last_finish_[cls]);
+  last_finish_[cls] = start + cost / weights_[cls];
+  // SchedulingQueue never queues more than capacity_[cls] items in a class
+  finish_[base_[cls] + (head_[cls] + count_[cls]) % capacity_[cls]]
+        = last_finish_[cls];
+  ++count_[cls];
+}
+
+std::size_t
+WeightedFairQueueing::select(const std::vector<std::size_t>& head_cost) {
+  std::size_t best = head_cost.size();
+  for (std::size_t cls = 0; cls < head_cost.size(); ++cls) {
+    if (head_cost[cls] != 0 && (best == head_cost.size()
+          || finish_[base_[cls] + head_[cls]]
+                < finish_[base_[best] + head_[best]])) {
+      best = cls;
+    }
+  }
+  return best;
+}
+
+void WeightedFairQueueing::dequeued(std::size_t cls, std::size_t cost) {
+  virtual_time_ = finish_[base_[cls] + head_[cls]];
+  head_[cls] = (head_[cls] + 1) % capacity_[cls];
+  --count_[cls];
+}
+
+};  // namespace core
+};  // namespace pfp
@@ -0,0 +1,144 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @file SchedulingPolicy.h
+ * Scheduling policies for SchedulingQueue.
+ *
+ * A policy is a plain class passed as the second template parameter of
+ * SchedulingQueue. It must provide:
+ *   void configure(const std::vector<std::size_t>& class_capacity);
+ *   void enqueued(std::size_t cls, std::size_t cost);
+ *   std::size_t select(const std::vector<std::size_t>& head_cost);
+ *   void dequeued(std::size_t cls, std::size_t cost);
+ * configure gets the capacity of each class, so a policy can size its
+ * per-item state once. head_cost[i] is the cost of the item at the head of
+ * class i, or 0 when the class is empty; select is only called when at least
+ * one class has data and must return a non-empty class.
+ */
+#ifndef CORE_SCHEDULINGPOLICY_H_
+#define CORE_SCHEDULINGPOLICY_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace pfp {
+namespace core {
+
+/**
+ * Always serve the lowest numbered non-empty class
+ */
+class StrictPriority {
+ public:
+  void configure(const std::vector<std::size_t>& class_capacity) {}
+  void enqueued(std::size_t cls, std::size_t cost) {}
+  std::size_t select(const std::vector<std::size_t>& head_cost);
+  void dequeued(std::size_t cls, std::size_t cost) {}
+};
+
+/**
+ * Serve up to weight[i] items from class i before moving to the next class
+ */
+class WeightedRoundRobin {
+ public:
+  /**
+   * @param weights  Items served per turn for each class (missing classes
+   *                 and zero weights are treated as 1)
+   */
+  explicit WeightedRoundRobin(std::vector<std::size_t> weights = {});
+  void configure(const std::vector<std::size_t>& class_capacity);
+  void enqueued(std::size_t cls, std::size_t cost) {}
+  std::size_t select(const std::vector<std::size_t>& head_cost);
+  void dequeued(std::size_t cls, std::size_t cost) {}
+
+ private:
+  std::vector<std::size_t> weights_;
+  std::size_t current_;
+  std::size_t credit_;     /*!< Items left in the current class's turn */
+};
+
+/**
+ * Deficit round robin: class i earns quantum[i] units of cost per round and
+ * is served while its deficit covers the cost of its head item
+ */
+class DeficitRoundRobin {
+ public:
+  /**
+   * @param quanta  Cost credited per round for each class (missing classes
+   *                and zero quanta are treated as 1)
+   */
+  explicit DeficitRoundRobin(std::vector<std::size_t> quanta = {});
+  void configure(const std::vector<std::size_t>& class_capacity);
+  void enqueued(std::size_t cls, std::size_t cost) {}
+  std::size_t select(const std::vector<std::size_t>& head_cost);
+  void dequeued(std::size_t cls, std::size_t cost);
+
+ private:
+  std::vector<std::size_t> quanta_;
+  std::vector<std::size_t> deficit_;
+  std::size_t current_;
+  bool fresh_visit_;       /*!< True until current_ has been credited */
+};
+
+/**
+ * Self-clocked weighted fair queueing: every item is stamped with a virtual
+ * finish time of max(V, last finish of its class) + cost / weight, and the
+ * item with the smallest finish time is served next
+ */
+class WeightedFairQueueing {
+ public:
+  /**
+   * @param weights  Share of each class (missing classes and zero weights
+   *                 are treated as 1)
+   */
+  explicit WeightedFairQueueing(std::vector<double> weights = {});
+  void configure(const std::vector<std::size_t>& class_capacity);
+  void enqueued(std::size_t cls, std::size_t cost);
+  std::size_t select(const std::vector<std::size_t>& head_cost);
+  void dequeued(std::size_t cls, std::size_t cost);
+
+ private:
+  std::vector<double> weights_;
+  std::vector<double> last_finish_;
+  //! Finish tags of the queued items: one ring per class, class i taking
+  //! capacity_[i] entries from base_[i]
+  std::vector<double> finish_;
+  std::vector<std::size_t> base_;
+  std::vector<std::size_t> capacity_;
+  std::vector<std::size_t> head_;   /*!< Oldest tag of each class */
+  std::vector<std::size_t> count_;  /*!< Tags queued in each class */
+  double virtual_time_;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_SCHEDULINGPOLICY_H_
@@ -0,0 +1,272 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class SchedulingQueue
+ * A multi-class, multiple-producer, multiple-consumer queue implemented using
+ * SystemC primitives.
+ * Each of the K classes is a bounded FIFO; pop() blocks until some class has
+ * data and then serves the class chosen by the Policy (StrictPriority,
+ * WeightedRoundRobin, DeficitRoundRobin or WeightedFairQueueing, see
+ * SchedulingPolicy.h). This replaces hand-built schedulers made of several
+ * MTQueues and a polling SC_THREAD.
+ *
+ *   SchedulingQueue<std::shared_ptr<Packet>, DeficitRoundRobin> q(
+ *         {64, 64, 128}, DeficitRoundRobin({1500, 1500, 3000}),
+ *         [](const std::shared_ptr<Packet>& p) { return p->size(); });
+ *   q.register_counters(this, "egress");
+ */
+#ifndef CORE_SCHEDULINGQUEUE_H_
+#define CORE_SCHEDULINGQUEUE_H_
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "systemc.h"
+#include "PFPObject.h"
+#include "RingBuffer.h"
+#include "SchedulingPolicy.h"
+
+namespace pfp {
+namespace core {
+
+template <typename T, typename Policy = StrictPriority>
+class SchedulingQueue {
+ public:
+  //! Returns the scheduling cost of an item (e.g. its size in bytes)
+  typedef std::function<std::size_t(const T&)> CostFunction;
+
+  /**
+   * Construct a SchedulingQueue
+   * @param class_capacity  Maximum number of items in each class; the number
+   *                        of entries is the number of classes
+   * @param policy          Scheduling policy
+   * @param cost            Cost of an item for DRR/WFQ (default: 1 per item)
+   * @throws std::invalid_argument if there are no classes or a class has
+   *         no room
+   */
+  explicit SchedulingQueue(const std::vector<std::size_t>& class_capacity,
+        Policy policy = Policy(), CostFunction cost = nullptr)
+  : capacity_(class_capacity), policy_(policy), cost_(cost),
+    head_cost_(class_capacity.size(), 0), size_(0),
+    mutex_(sc_gen_unique_name("mutex_")),
+    cond_not_empty_(sc_gen_unique_name("cond_not_empty_")),
+    cond_not_full_(new sc_event[class_capacity.size()]),
+    owner_(nullptr) {
+    if (capacity_.empty()) {
+      throw std::invalid_argument("SchedulingQueue needs at least one class");
+    }
+    for (auto capacity : capacity_) {
+      if (capacity == 0) {
+        throw std::invalid_argument("SchedulingQueue class capacity must be "
+              "positive");
+      }
+      classes_.emplace_back(new RingBuffer<Entry>(capacity));
+    }
+    policy_.configure(capacity_);
+  }
+
+  /**
+   * Pop the item chosen by the scheduling policy
+   * @return  The item, moved out of the queue
+   */
+  T pop() {
+    while (size_ == 0) {
+      wait(cond_not_empty_);
+    }
+    return take();
+  }
+
+  /**
+   * Pop the item chosen by the scheduling policy into the output argument
+   * @param  Output argument
+   */
+  void pop(T& item) {
+    item = pop();
+  }
+
+  /**
+   * Pop the item chosen by the scheduling policy if any class has data,
+   * without blocking
+   * @param  Output argument
+   * @return True if an item was popped
+   */
+  bool try_pop(T& item) {
+    if (size_ == 0) {
+      return false;
+    }
+    item = take();
+    return true;
+  }
+
+  /**
+   * Push an item onto a class, waiting while that class is full
+   * @param  Class of the item
+   * @param  Item to push
+   */
+  void push(std::size_t cls, T item) {
+    check_class(cls);
+    while (full(cls)) {
+      wait(cond_not_full_[cls]);
+    }
+    put(cls, std::move(item));
+  }
+
+  /**
+   * Push an item onto a class if it has room, without blocking
+   * @param  Class of the item
+   * @param  Item to push
+   * @return True if the item was queued, false if the class was full
+   */
+  bool try_push(std::size_t cls, T item) {
+    check_class(cls);
+    if (full(cls)) {
+      count(rejected_, cls);
+      return false;
+    }
+    put(cls, std::move(item));
+    return true;
+  }
+
+  /**
+   * Add per-class enqueued/dequeued/rejected counters to a module. Counters
+   * are named <prefix>_class<i>_<event>.
+   * @param owner   Module that owns the counters
+   * @param prefix  Prefix for the counter names
+   */
+  void register_counters(PFPObject* owner, const std::string& prefix) {
+    owner_ = owner;
+    enqueued_.clear();
+    dequeued_.clear();
+    rejected_.clear();
+    for (std::size_t cls = 0; cls < num_classes(); ++cls) {
+      const std::string base = prefix + "_class" + std::to_string(cls) + "_";
+      enqueued_.push_back(counter(base + "enqueued"));
+      dequeued_.push_back(counter(base + "dequeued"));
+      rejected_.push_back(counter(base + "rejected"));
+    }
+  }
+
+  std::size_t num_classes() const {
+    return classes_.size();
+  }
+
+  std::size_t size(std::size_t cls) const {
+    check_class(cls);
+    return classes_[cls]->size();
+  }
+
+  std::size_t size() const {
+    return size_;
+  }
+
+  bool full(std::size_t cls) const {
+    check_class(cls);
+    return classes_[cls]->size() == capacity_[cls];
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+ private:
+  struct Entry {
+    Entry(T i, std::size_t c) : item(std::move(i)), cost(c) {}
+    T item;
+    std::size_t cost;
+  };
+
+  void check_class(std::size_t cls) const {
+    if (cls >= num_classes()) {
+      throw std::out_of_range("SchedulingQueue class " + std::to_string(cls)
+            + " out of range (" + std::to_string(num_classes())
+            + " classes)");
+    }
+  }
+
+  void put(std::size_t cls, T&& item) {
+    const std::size_t cost = cost_ ? std::max<std::size_t>(cost_(item), 1) : 1;
+    mutex_.lock();
+    classes_[cls]->emplace_back(std::move(item), cost);
+    head_cost_[cls] = classes_[cls]->front().cost;
+    ++size_;
+    policy_.enqueued(cls, cost);
+    mutex_.unlock();
+    count(enqueued_, cls);
+    cond_not_empty_.notify();
+  }
+
+  T take() {
+    mutex_.lock();
+    const std::size_t cls = policy_.select(head_cost_);
+    Entry entry = classes_[cls]->pop_front();
+    head_cost_[cls] = classes_[cls]->empty() ? 0 : classes_[cls]->front().cost;
+    --size_;
+    policy_.dequeued(cls, entry.cost);
+    mutex_.unlock();
+    count(dequeued_, cls);
+    cond_not_full_[cls].notify();
+    return std::move(entry.item);
+  }
+
+  CounterHandle counter(const std::string& name) {
+    CounterHandle handle = owner_->register_counter(name);
+    return handle ? handle : owner_->counter_handle(name);
+  }
+
+  void count(const std::vector<CounterHandle>& counters, std::size_t cls) {
+    if (owner_) {
+      owner_->increment_counter(counters[cls]);
+    }
+  }
+
+  std::vector<std::size_t> capacity_;           /*!< Bound of each class */
+  std::vector<std::unique_ptr<RingBuffer<Entry>>> classes_;
+  Policy policy_;
+  CostFunction cost_;
+  std::vector<std::size_t> head_cost_;  /*!< Head item cost, 0 when empty */
+  std::size_t size_;                    /*!< Items over all classes */
+  sc_mutex mutex_;                      /*!< Guard */
+  sc_event cond_not_empty_;             /*!< Notified on every push */
+  //! Per-class events notified when an item leaves the class
+  std::unique_ptr<sc_event[]> cond_not_full_;
+  PFPObject* owner_;                    /*!< Module holding the counters */
+  std::vector<CounterHandle> enqueued_, dequeued_, rejected_;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_SCHEDULINGQUEUE_H_
@@ -33,6 +33,7 @@
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <vector>
 #include "PFPConfig.h"
 
 std::string to_hex_string(const void * key, size_t length) {
@@ -69,3 +70,46 @@ std::string to_binary_string(uint8_t * prefix, int width) {
   }
   return output;
 }
+
+std::string join_path(const std::string& dir, const std::string& name) {
+  return (dir.empty() || dir.back() == '/') ? dir + name : dir + "/" + name;
+}
+
+std::string csv_field(const std::string& text) {
+  if (text.find_first_of(",\"\n") == std::string::npos) {
+    return text;
+  }
+  std::string quoted = "\"";
+  for (char c : text) {
+    if (c == '"') {
+      quoted += '"';
+    }
+    quoted += c;
+  }
+  return quoted + '"';
+}
+
+std::vector<std::string> split_csv_line(const std::string& line) {
+  std::vector<std::string> fields(1);
+  bool quoted = false;
+  for (std::size_t i = 0; i < line.size(); ++i) {
+    const char c = line[i];
+    if (quoted) {
+      if (c != '"') {
+        fields.back() += c;
+      } else if (i + 1 < line.size() && line[i + 1] == '"') {
+        fields.back() += '"';
+        ++i;
+      } else {
+        quoted = false;
+      }
+    } else if (c == '"') {
+      quoted = true;
+    } else if (c == ',') {
+      fields.emplace_back();
+    } else {
+      fields.back() += c;
+    }
+  }
+  return fields;
+}
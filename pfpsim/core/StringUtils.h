@@ -33,9 +33,33 @@
 
 #include <string>
 #include <cstddef>
+#include <vector>
 
 std::string to_hex_string(const void * key, size_t length);
 
 std::string to_binary_string(uint8_t * prefix, int width);
 
+/**
+ * Path of a file in a directory
+ * @param dir   Directory, with or without a trailing '/'; empty for the
+ *              working directory
+ * @param name  File name
+ * @return      dir and name joined by exactly one '/'
+ */
+std::string join_path(const std::string& dir, const std::string& name);
+
+/**
+ * Quote a value for a CSV file if it holds a separator, a quote or a newline
+ * @param text  Value to write
+ * @return      text, or text in double quotes with its quotes doubled
+ */
+std::string csv_field(const std::string& text);
+
+/**
+ * Split one line of a CSV file into its fields, undoing csv_field
+ * @param line  Line without its newline
+ * @return      Unquoted fields
+ */
+std::vector<std::string> split_csv_line(const std::string& line);
+
 #endif  // CORE_STRINGUTILS_H_
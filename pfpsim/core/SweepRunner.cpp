@@ -0,0 +1,311 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "SweepRunner.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "json.hpp"
+#include "StringUtils.h"
+
+namespace pfp {
+namespace core {
+
+namespace {
+typedef nlohmann::json json;
+
+std::string value_string(const json& value) {
+  return value.is_string() ? value.get<std::string>() : value.dump();
+}
+
+void make_directory(const std::string& path) {
+  if (::mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+    throw std::runtime_error("Cannot create sweep directory " + path);
+  }
+}
+
+void spec_error(const std::string& spec_file, const std::string& what) {
+  throw std::runtime_error("Invalid sweep " + spec_file + ": " + what);
+}
+}  // namespace
+
+SweepRunner::SweepRunner(const std::string& spec_file) {
+  std::ifstream ifs(spec_file);
+  if (ifs.fail()) {
+    throw std::runtime_error("Cannot read sweep " + spec_file);
+  }
+  json spec;
+  try {
+    spec = json::parse(std::string((std::istreambuf_iterator<char>(ifs)),
+                                   (std::istreambuf_iterator<char>())));
+  } catch (const std::invalid_argument& e) {
+    spec_error(spec_file, e.what());
+  }
+  if (!spec.is_object() || spec.find("parameters") == spec.end()
+        || !spec["parameters"].is_object() || spec["parameters"].empty()) {
+    spec_error(spec_file, "expected a non-empty \"parameters\" object");
+  }
+  const json& parameters = spec["parameters"];
+  std::vector<const json*> values;
+  for (auto it = parameters.cbegin(); it != parameters.cend(); ++it) {
+    const json& value = it.value();
+    const bool is_list = value.is_array() && !value.empty();
+    const bool is_range = value.is_object()
+          && value.find("min") != value.end() && value["min"].is_number()
+          && value.find("max") != value.end() && value["max"].is_number();
+    if (!is_list && !is_range) {
+      spec_error(spec_file, it.key()
+            + " must be a list of values or a {\"min\", \"max\"} range");
+    }
+    parameters_.push_back(it.key());
+    values.push_back(&value);
+  }
+
+  if (spec.find("samples") == spec.end()) {
+    // Full grid, the last parameter varying fastest
+    std::vector<std::size_t> position(values.size(), 0);
+    for (auto value : values) {
+      if (!value->is_array()) {
+        spec_error(spec_file, "ranges need \"samples\"");
+      }
+    }
+    for (;;) {
+      Point point;
+      for (std::size_t i = 0; i < values.size(); ++i) {
+        point.emplace_back(parameters_[i],
+              value_string((*values[i])[position[i]]));
+      }
+      points_.push_back(point);
+      std::size_t i = values.size();
+      while (i > 0 && ++position[i - 1] == values[i - 1]->size()) {
+        position[--i] = 0;
+      }
+      if (i == 0) {
+        break;
+      }
+    }
+  } else {
+    const json& samples = spec["samples"];
+    if (!samples.is_number_integer() || samples.get<int64_t>() <= 0) {
+      spec_error(spec_file, "\"samples\" must be a positive integer");
+    }
+    std::mt19937_64 random(spec.find("seed") == spec.end() ? 1
+          : spec["seed"].get<uint64_t>());
+    for (int64_t n = 0; n < samples.get<int64_t>(); ++n) {
+      Point point;
+      for (std::size_t i = 0; i < values.size(); ++i) {
+        const json& value = *values[i];
+        json sample;
+        if (value.is_array()) {
+          std::uniform_int_distribution<std::size_t> pick(0,
+                value.size() - 1);
+          sample = value[pick(random)];
+        } else if (value["min"].is_number_integer()
+              && value["max"].is_number_integer()) {
+          std::uniform_int_distribution<int64_t> pick(
+                value["min"].get<int64_t>(), value["max"].get<int64_t>());
+          sample = pick(random);
+        } else {
+          std::uniform_real_distribution<double> pick(
+                value["min"].get<double>(), value["max"].get<double>());
+          sample = pick(random);
+        }
+        point.emplace_back(parameters_[i], value_string(sample));
+      }
+      points_.push_back(point);
+    }
+  }
+}
+
+std::string SweepRunner::point_directory(const std::string& output_dir,
+      std::size_t index) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "point.%05zu/", index);
+  return join_path(output_dir, name);
+}
+
+int SweepRunner::run(const std::string& output_dir, unsigned jobs) {
+  if (jobs == 0) {
+    throw std::invalid_argument("SweepRunner needs at least one job");
+  }
+  make_directory(output_dir);
+  status_.assign(points_.size(), -1);
+  std::map<pid_t, std::size_t> running;
+  std::size_t next = 0;
+  while (next < points_.size() || !running.empty()) {
+    while (running.size() < jobs && next < points_.size()) {
+      const std::string dir = point_directory(output_dir, next);
+      make_directory(dir);
+      // Do not let the children inherit buffered output
+      std::cout.flush();
+      std::cerr.flush();
+      std::fflush(nullptr);
+      const pid_t pid = ::fork();
+      if (pid < 0) {
+        throw std::runtime_error("Cannot fork sweep point "
+              + std::to_string(next));
+      }
+      if (pid == 0) {
+        const int log = ::open((dir + "log.txt").c_str(),
+              O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (log >= 0) {
+          ::dup2(log, STDOUT_FILENO);
+          ::dup2(log, STDERR_FILENO);
+          ::close(log);
+        }
+        return static_cast<int>(next);
+      }
+      std::cout << "Sweep point " << next << " started (pid " << pid << ")"
+          << std::endl;
+      running[pid] = next++;
+    }
+    int wait_status;
+    const pid_t pid = ::waitpid(-1, &wait_status, 0);
+    if (pid < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;  // no children left
+    }
+    auto it = running.find(pid);
+    if (it == running.end()) {
+      continue;
+    }
+    const std::size_t index = it->second;
+    running.erase(it);
+    status_[index] = WIFEXITED(wait_status) ? WEXITSTATUS(wait_status) : -1;
+    std::cout << "Sweep point " << index << " finished with status "
+        << status_[index] << " (" << points_.size() - next + running.size()
+        << " left)" << std::endl;
+  }
+  return -1;
+}
+
+void SweepRunner::read_counters(const std::string& path, Row* row) {
+  std::ifstream csv(path);
+  std::string header, line;
+  if (!std::getline(csv, header)) {
+    return;
+  }
+  // module,counter,value
+  while (std::getline(csv, line)) {
+    const auto values = split_csv_line(line);
+    if (values.size() < 3) {
+      continue;
+    }
+    (*row)[values[0] + "." + values[1]] = values[2];
+  }
+}
+
+void SweepRunner::read_histograms(const std::string& path, Row* row) {
+  std::ifstream csv(path);
+  std::string header, line;
+  if (!std::getline(csv, header)) {
+    return;
+  }
+  // module,histogram,<statistic>,...
+  const auto statistics = split_csv_line(header);
+  while (std::getline(csv, line)) {
+    const auto values = split_csv_line(line);
+    if (values.size() < 2) {
+      continue;
+    }
+    const std::string prefix = values[0] + "." + values[1] + ".";
+    for (std::size_t i = 2; i < statistics.size() && i < values.size(); ++i) {
+      (*row)[prefix + statistics[i]] = values[i];
+    }
+  }
+}
+
+std::string SweepRunner::collect(const std::string& output_dir) const {
+  std::vector<Row> counters(points_.size()), histograms(points_.size());
+  std::set<std::string> counter_columns, histogram_columns;
+  for (std::size_t i = 0; i < points_.size(); ++i) {
+    const std::string dir = point_directory(output_dir, i);
+    read_counters(dir + "counter_totals.csv", &counters[i]);
+    read_histograms(dir + "histograms.csv", &histograms[i]);
+    for (auto& value : counters[i]) {
+      counter_columns.insert(value.first);
+    }
+    for (auto& value : histograms[i]) {
+      histogram_columns.insert(value.first);
+    }
+  }
+
+  const std::string path = join_path(output_dir, "sweep.csv");
+  std::ofstream csv(path);
+  csv << "point,status";
+  for (auto& name : parameters_) {
+    csv << "," << csv_field(name);
+  }
+  for (auto& name : counter_columns) {
+    csv << "," << csv_field(name);
+  }
+  for (auto& name : histogram_columns) {
+    csv << "," << csv_field(name);
+  }
+  csv << "\n";
+  for (std::size_t i = 0; i < points_.size(); ++i) {
+    csv << i << "," << (i < status_.size() ? status_[i] : -1);
+    for (auto& value : points_[i]) {
+      csv << "," << csv_field(value.second);
+    }
+    for (auto& name : counter_columns) {
+      auto it = counters[i].find(name);
+      csv << "," << (it != counters[i].end() ? it->second : "");
+    }
+    for (auto& name : histogram_columns) {
+      auto it = histograms[i].find(name);
+      csv << "," << (it != histograms[i].end() ? it->second : "");
+    }
+    csv << "\n";
+  }
+  if (!csv) {
+    throw std::runtime_error("Cannot write sweep results " + path);
+  }
+  return path;
+}
+
+};  // namespace core
+};  // namespace pfp
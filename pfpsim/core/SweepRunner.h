@@ -0,0 +1,139 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class SweepRunner
+ * Runs a simulation model once per point of a design-space sweep, in
+ * parallel child processes.
+ * The sweep is described by a json file:
+ *
+ *   {
+ *     "parameters": {
+ *       "queue_size": [16, 32, 64],
+ *       "threads": [1, 2, 4],
+ *       "clock_ns": {"min": 1.0, "max": 4.0}
+ *     },
+ *     "samples": 20,
+ *     "seed": 1
+ *   }
+ *
+ * Without "samples" every parameter must be a list of values and the sweep
+ * is their full grid (cartesian product). With "samples", that many points
+ * are drawn at random (with the given seed, 1 by default): a list gives a
+ * uniformly chosen value, a {"min", "max"} range a uniform value in the
+ * range, integral when both bounds are integers.
+ * Each point runs as a child process forked before elaboration, at most
+ * jobs at a time. A child gets its own OUTPUTDIR, <output>/point.<index>/,
+ * where its standard output and error go to log.txt, and the values of the
+ * point as -X <name> <value> arguments (see PFPConfig::get_command_line_arg).
+ * When every child has exited, the final counter values (counter_totals.csv)
+ * and histogram summaries (histograms.csv) that each point writes at the end
+ * of its simulation are collected into <output>/sweep.csv, one row per
+ * point.
+ */
+#ifndef CORE_SWEEPRUNNER_H_
+#define CORE_SWEEPRUNNER_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pfp {
+namespace core {
+
+class SweepRunner {
+ public:
+  //! Parameter values of one point, as (name, value) pairs
+  typedef std::vector<std::pair<std::string, std::string>> Point;
+
+  /**
+   * Construct a SweepRunner and generate the points of a sweep
+   * @param spec_file  Path of the json sweep description
+   * @throws std::runtime_error if the file cannot be read or is invalid
+   */
+  explicit SweepRunner(const std::string& spec_file);
+
+  /**
+   * Fork one child process per point, at most jobs at a time.
+   * The parent waits for all children and returns -1. A child returns the
+   * index of its point, with its standard output and error redirected; it
+   * is expected to run the simulation and exit.
+   * @param output_dir  Directory of the point directories and results
+   * @param jobs        Maximum number of concurrent children, at least 1
+   * @return            Index of the point to run, or -1 in the parent
+   */
+  int run(const std::string& output_dir, unsigned jobs);
+
+  /**
+   * Write <output_dir>/sweep.csv from the outputs of the points.
+   * Columns: point, status (exit code of the child), the parameters, then
+   * every counter and histogram statistic found in any point; missing
+   * values are left empty.
+   * @param output_dir  Directory given to run
+   * @return            Path of the results table
+   */
+  std::string collect(const std::string& output_dir) const;
+
+  //! Points of the sweep, in run order
+  const std::vector<Point>& points() const {
+    return points_;
+  }
+
+  //! Exit code of each point's child, -1 for a child killed by a signal
+  const std::vector<int>& status() const {
+    return status_;
+  }
+
+  /**
+   * Directory of a point
+   * @param output_dir  Directory given to run
+   * @param index       Index of the point
+   * @return            <output_dir>/point.<index>/
+   */
+  static std::string point_directory(const std::string& output_dir,
+        std::size_t index);
+
+ private:
+  typedef std::map<std::string, std::string> Row;
+
+  static void read_counters(const std::string& path, Row* row);
+  static void read_histograms(const std::string& path, Row* row);
+
+  std::vector<std::string> parameters_;
+  std::vector<Point> points_;
+  std::vector<int> status_;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_SWEEPRUNNER_H_
@@ -0,0 +1,274 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "UtilizationObserver.h"
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include "PFPConfig.h"
+#include "PFPContext.h"
+
+namespace pfp {
+namespace core {
+
+UtilizationObserver::UtilizationObserver(double snapshot_interval,
+      std::ostream& out)
+  : snapshot_interval_(snapshot_interval), out_(out),
+    interval_start_(0) {
+  end_of_simulation_handle_ = PFPContext::get_current_context()
+        .at_end_of_simulation([this]() {
+          finish(sc_time_stamp().to_default_time_units());
+          report(out_);
+        });
+}
+
+UtilizationObserver::~UtilizationObserver() {
+  PFPContext::get_current_context().cancel_end_of_simulation(
+        end_of_simulation_handle_);
+}
+
+void UtilizationObserver::observe(const ObserverEvent& event) {
+  const double now = event.time;
+  snapshots_until(now);
+  // Thread and core events carry the TEU as module and the TEC as name
+  Engine& e = engine(event.name, event.module, now);
+  switch (event.kind) {
+    case ObserverEvent::Kind::ThreadBegin:
+      thread_begin(e, event.value, now);
+      break;
+    case ObserverEvent::Kind::ThreadEnd:
+    case ObserverEvent::Kind::ThreadIdle:
+      thread_end(e, event.value, now);
+      break;
+    case ObserverEvent::Kind::CoreBusy:
+      core_busy(e, now);
+      break;
+    case ObserverEvent::Kind::CoreIdle:
+      core_idle(e, now);
+      break;
+    default:
+      break;
+  }
+  e.last = std::max(e.last, now);
+}
+
+UtilizationObserver::Engine& UtilizationObserver::engine(NameTable::Id tec,
+      NameTable::Id teu, double now) {
+  const uint64_t key = (static_cast<uint64_t>(tec) << 32) | teu;
+  auto it = engines_.find(key);
+  if (it == engines_.end()) {
+    Engine e;
+    e.tec = tec;
+    e.teu = teu;
+    e.first = e.last = now;
+    e.busy = false;
+    e.busy_since = e.busy_time = e.interval_busy_time = 0;
+    e.idle_since = -1;
+    e.level_since = now;
+    e.time_at_level.assign(1, 0);
+    e.packets = e.interval_packets = 0;
+    it = engines_.emplace(key, std::move(e)).first;
+  }
+  return it->second;
+}
+
+void UtilizationObserver::thread_begin(Engine& e, uint64_t thread,
+      double now) {
+  set_level(e, now);
+  e.active[thread] = now;
+}
+
+void UtilizationObserver::thread_end(Engine& e, uint64_t thread,
+      double now) {
+  auto it = e.active.find(thread);
+  if (it == e.active.end()) {
+    return;
+  }
+  set_level(e, now);
+  e.service.record(PFPConfig::picoseconds(now - it->second));
+  ++e.packets;
+  ++e.interval_packets;
+  e.active.erase(it);
+}
+
+void UtilizationObserver::set_level(Engine& e, double now) {
+  const std::size_t level = e.active.size();
+  if (level >= e.time_at_level.size()) {
+    e.time_at_level.resize(level + 1, 0);
+  }
+  e.time_at_level[level] += now - e.level_since;
+  e.level_since = now;
+}
+
+void UtilizationObserver::core_busy(Engine& e, double now) {
+  if (e.busy) {
+    return;
+  }
+  if (e.idle_since >= 0) {
+    e.idle_gap.record(PFPConfig::picoseconds(now - e.idle_since));
+  }
+  e.busy = true;
+  e.busy_since = now;
+}
+
+void UtilizationObserver::core_idle(Engine& e, double now) {
+  if (!e.busy) {
+    return;
+  }
+  e.busy = false;
+  e.busy_time += now - e.busy_since;
+  e.interval_busy_time += now - std::max(e.busy_since, interval_start_);
+  e.idle_since = now;
+}
+
+void UtilizationObserver::snapshots_until(double now) {
+  if (snapshot_interval_ <= 0) {
+    return;
+  }
+  while (now >= interval_start_ + snapshot_interval_) {
+    snapshot(interval_start_ + snapshot_interval_);
+  }
+}
+
+void UtilizationObserver::snapshot(double end) {
+  const double length = end - interval_start_;
+  out_ << "Utilization [" << interval_start_ << ", " << end << "):"
+       << std::endl;
+  for (auto& each : sorted()) {
+    Engine& e = engines_[each.second];
+    if (e.busy) {
+      e.interval_busy_time += end - std::max(e.busy_since, interval_start_);
+    }
+    out_ << "  " << each.first.first << "." << each.first.second
+         << ": busy " << 100 * e.interval_busy_time / length
+         << "%, packets " << e.interval_packets << std::endl;
+    e.interval_busy_time = 0;
+    e.interval_packets = 0;
+  }
+  interval_start_ = end;
+}
+
+void UtilizationObserver::finish(double now) {
+  if (snapshot_interval_ <= 0) {
+    return;
+  }
+  snapshots_until(now);
+  if (now > interval_start_) {
+    snapshot(now);
+  }
+}
+
+double UtilizationObserver::window_end(const Engine& e) const {
+  return std::max(e.last, sc_time_stamp().to_default_time_units());
+}
+
+double UtilizationObserver::busy_time(const Engine& e, double end) {
+  return e.busy_time + (e.busy ? end - e.busy_since : 0);
+}
+
+void UtilizationObserver::report(std::ostream& os) const {
+  os << "Utilization report:" << std::endl;
+  for (auto& each : sorted()) {
+    const Engine& e = engines_.at(each.second);
+    const double end = window_end(e);
+    const double span = end - e.first;
+    const double busy = busy_time(e, end);
+    os << "Engine " << each.first.first << "." << each.first.second << ":"
+       << std::endl
+       << "  busy fraction:      " << (span > 0 ? busy / span : 0)
+       << std::endl
+       << "  packets:            " << e.packets << std::endl
+       << "  service time (ps):  ";
+    e.service.summary(os);
+    os << std::endl << "  idle gaps (ps):     ";
+    e.idle_gap.summary(os);
+    os << std::endl << "  active threads:    ";
+    // The current level lasts until the end of the window
+    std::vector<double> time_at_level(e.time_at_level);
+    time_at_level.resize(std::max(time_at_level.size(), e.active.size() + 1),
+          0);
+    time_at_level[e.active.size()] += end - e.level_since;
+    double total = 0;
+    for (double t : time_at_level) {
+      total += t;
+    }
+    for (std::size_t level = 0; level < time_at_level.size(); ++level) {
+      os << " " << level << ":"
+         << (total > 0 ? 100 * time_at_level[level] / total : 0) << "%";
+    }
+    os << std::endl;
+  }
+}
+
+double UtilizationObserver::busy_fraction(const std::string& tec_mod,
+      const std::string& teu_mod) const {
+  const Engine* found = find_engine(tec_mod, teu_mod);
+  if (!found) {
+    return 0;
+  }
+  const Engine& e = *found;
+  const double end = window_end(e);
+  const double span = end - e.first;
+  return span > 0 ? busy_time(e, end) / span : 0;
+}
+
+const Histogram& UtilizationObserver::service_time(const std::string& tec_mod,
+      const std::string& teu_mod) const {
+  const Engine* e = find_engine(tec_mod, teu_mod);
+  return e ? e->service : empty_;
+}
+
+const UtilizationObserver::Engine* UtilizationObserver::find_engine(
+      const std::string& tec_mod, const std::string& teu_mod) const {
+  auto& names = NameTable::get();
+  const NameTable::Id tec = names.find(tec_mod);
+  const NameTable::Id teu = names.find(teu_mod);
+  if (tec == NameTable::invalid || teu == NameTable::invalid) {
+    return nullptr;
+  }
+  auto it = engines_.find((static_cast<uint64_t>(tec) << 32) | teu);
+  return it == engines_.end() ? nullptr : &it->second;
+}
+
+std::map<std::pair<std::string, std::string>, uint64_t>
+UtilizationObserver::sorted() const {
+  auto& names = NameTable::get();
+  std::map<std::pair<std::string, std::string>, uint64_t> result;
+  for (auto& each : engines_) {
+    result.emplace(std::make_pair(names.name(each.second.tec),
+          names.name(each.second.teu)), each.first);
+  }
+  return result;
+}
+
+};  // namespace core
+};  // namespace pfp
@@ -0,0 +1,168 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class UtilizationObserver
+ * Observer which accounts how busy the processing engines of a model are,
+ * from the thread_* and core_* notifications of the TEUs:
+ *  - per core: busy fraction, and the distribution of idle gaps between a
+ *    core_idle and the next core_busy
+ *  - per TEU: time-weighted distribution of the number of active threads,
+ *    and the service time of each packet from thread_begin to thread_end
+ * A report is printed when the simulation ends; with a snapshot interval,
+ * the busy fraction and throughput of every engine over each interval are
+ * printed as well, so saturated engines show up without a trace dump.
+ * Statistics cover each engine from its first event up to the current
+ * simulation time, so an engine that has gone idle is not reported busy.
+ * Times are in picoseconds.
+ *
+ *   top->attach_observer(std::make_shared<UtilizationObserver>(1000));
+ */
+#ifndef CORE_UTILIZATIONOBSERVER_H_
+#define CORE_UTILIZATIONOBSERVER_H_
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <unordered_map>
+#include <vector>
+#include "EventObserver.h"
+#include "Histogram.h"
+#include "NameTable.h"
+
+namespace pfp {
+namespace core {
+
+class UtilizationObserver : public EventObserver {
+ public:
+  /**
+   * Construct a UtilizationObserver
+   * @param snapshot_interval  Length of the snapshot intervals in simulation
+   *                           time units (sc_get_default_time_unit), or 0
+   *                           for the end of simulation report only
+   * @param out                Stream receiving snapshots and the report
+   */
+  explicit UtilizationObserver(double snapshot_interval = 0,
+        std::ostream& out = std::cout);
+  ~UtilizationObserver();
+
+  void observe(const ObserverEvent& event) override;
+
+  uint32_t interests() const override {
+    return ObserverEvent::Threads | ObserverEvent::Cores;
+  }
+
+  /**
+   * Write the statistics accumulated so far
+   * @param os  Stream to write to
+   */
+  void report(std::ostream& os) const;
+
+  /**
+   * Busy fraction of a core from its first event to the current simulation
+   * time
+   * @param tec_mod  TEC of the core
+   * @param teu_mod  TEU of the core
+   * @return         Fraction in [0, 1], 0 for an unknown core
+   */
+  double busy_fraction(const std::string& tec_mod,
+        const std::string& teu_mod) const;
+
+  /**
+   * Service times of the packets processed by a TEU, in picoseconds
+   * @param tec_mod  TEC of the TEU
+   * @param teu_mod  TEU
+   * @return         Histogram, empty for an unknown TEU
+   */
+  const Histogram& service_time(const std::string& tec_mod,
+        const std::string& teu_mod) const;
+
+ private:
+  //! Accounting for one TEU and its core
+  struct Engine {
+    NameTable::Id tec;
+    NameTable::Id teu;
+    double first;               /*!< Time of the first event */
+    double last;                /*!< Time of the latest event */
+    // Core
+    bool busy;
+    double busy_since;
+    double busy_time;
+    double interval_busy_time;  /*!< Busy time in the current interval */
+    double idle_since;          /*!< Start of the current idle gap, or < 0 */
+    Histogram idle_gap;
+    // Threads
+    std::unordered_map<uint64_t, double> active;  /*!< Thread -> start */
+    double level_since;         /*!< Time active.size() last changed */
+    std::vector<double> time_at_level;  /*!< Time spent per active count */
+    Histogram service;
+    uint64_t packets;
+    uint64_t interval_packets;
+  };
+
+  Engine& engine(NameTable::Id tec, NameTable::Id teu, double now);
+  //! Engine of a TEU given by name, nullptr if it has no events
+  const Engine* find_engine(const std::string& tec_mod,
+        const std::string& teu_mod) const;
+  void thread_begin(Engine& e, uint64_t thread, double now);
+  void thread_end(Engine& e, uint64_t thread, double now);
+  void set_level(Engine& e, double now);
+  void core_busy(Engine& e, double now);
+  void core_idle(Engine& e, double now);
+  void snapshots_until(double now);
+  //! Print the snapshot of the interval from interval_start_ to end
+  void snapshot(double end);
+  //! Close the statistics at the end of the simulation and print the
+  //! snapshot of the last, partial interval
+  void finish(double now);
+  //! End of the window the statistics of an engine cover
+  double window_end(const Engine& e) const;
+  //! Busy time of a core up to end
+  static double busy_time(const Engine& e, double end);
+  //! Keys of engines_, ordered by TEC and TEU name
+  std::map<std::pair<std::string, std::string>, uint64_t> sorted() const;
+
+  const double snapshot_interval_;
+  std::ostream& out_;
+  double interval_start_;
+  //! Engines keyed by (TEC id << 32) | TEU id
+  std::unordered_map<uint64_t, Engine> engines_;
+  const Histogram empty_;
+  std::size_t end_of_simulation_handle_;
+};
+
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_UTILIZATIONOBSERVER_H_
@@ -95,6 +95,21 @@ void DebugObserver::counter_updated(const std::string& module_name,
         << counter_name << ": " << new_value << " @ "
         << simulation_time << std::endl;
   }
+  counter_updated(NameTable::get().intern(counter_name), new_value,
+        simulation_time);
+}
+
+void DebugObserver::observe(const ObserverEvent& event) {
+  if (event.kind == ObserverEvent::Kind::CounterUpdated && !VERBOSE) {
+    counter_updated(event.name, event.value, event.time);
+  } else {
+    PFPObserver::observe(event);
+  }
+}
+
+void DebugObserver::counter_updated(NameTable::Id counter_id,
+      std::size_t new_value, double simulation_time) {
+  const std::string& counter_name = NameTable::get().name(counter_id);
   int old_value = data_manager->getCounterValue(counter_name);
   if (old_value == -1) {
     old_value = 0;
@@ -109,7 +124,7 @@ void DebugObserver::counter_updated(const std::string& module_name,
   updateSimulationTime(simulation_time);
   std::vector<Watchpoint>& watchpoints = data_manager->getWatchpointList();
   for (auto it = watchpoints.begin(); it != watchpoints.end(); it++) {
-    if (counter_name == it->getCounterName() && !it->disabled) {
+    if (counter_id == it->getCounterId() && !it->disabled) {
       WatchpointHitMessage *watchpoint_hit_msg
           = new WatchpointHitMessage(
                 it->getID(), counter_name, old_value, new_value);
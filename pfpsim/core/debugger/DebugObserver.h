@@ -101,6 +101,21 @@ class DebugObserver : public PFPObserver {
         std::size_t new_value,
         double simulation_time);
 
+  /**
+   * Handle a queued event; counter updates are handled by counter id
+   * without going through the string callbacks
+   * @param event		Event to handle
+   */
+  void observe(const ObserverEvent& event) override;
+
+  /**
+   * All events, with every counter change: watchpoints must see each value
+   * even in modules that coalesce counter updates
+   */
+  uint32_t interests() const override {
+    return ObserverEvent::AllEvents | ObserverEvent::ExactCounters;
+  }
+
   /**
    * Function called by the simulation when data is written by a module
    * @param from_module		Module name of the transmitting module
@@ -188,6 +203,15 @@ class DebugObserver : public PFPObserver {
   void enableDebugger();
 
  private:
+  /**
+   * Record a counter update, matching watchpoints by counter id
+   * @param counter_id		Interned name of the counter
+   * @param new_value			Current value of the counter
+   * @param simulation_time	Simulation time at which counter value was updated
+   */
+  void counter_updated(NameTable::Id counter_id, std::size_t new_value,
+        double simulation_time);
+
   DebuggerIPCServer *ipc_server;   /*!< Pointer to IPCServer. */
   DebugDataManager *data_manager;    /*!< Pointer to DebugDataManager. */
   bool enable = false;   /*!< Indicates if the debugger is enabled. */
@@ -37,12 +37,13 @@ namespace db {
 
 int Watchpoint::next_id = 0;
 
-Watchpoint::Watchpoint(): disabled(false) {
+Watchpoint::Watchpoint(): disabled(false), counter_id(0) {
   id = next_id++;
 }
 
 Watchpoint::Watchpoint(std::string name, bool dis): Watchpoint() {
   counter_name = name;
+  counter_id = NameTable::get().intern(counter_name);
   disabled = dis;
 }
 
@@ -54,6 +55,10 @@ std::string Watchpoint::getCounterName() const {
   return counter_name;
 }
 
+NameTable::Id Watchpoint::getCounterId() const {
+  return counter_id;
+}
+
 };  // namespace db
 };  // namespace core
 };  // namespace pfp
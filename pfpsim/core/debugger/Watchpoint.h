@@ -41,6 +41,7 @@
 
 #include <string>
 #include <iostream>
+#include "../NameTable.h"
 
 namespace pfp {
 namespace core {
@@ -76,12 +77,19 @@ class Watchpoint {
    */
   std::string getCounterName() const;
 
+  /**
+   * Get the interned name of the counter the Watchpoint is set on.
+   * @return NameTable id of the counter name.
+   */
+  NameTable::Id getCounterId() const;
+
   bool disabled;   /*!< Indicates if the Watchpoint is disabled. */
 
  private:
   int id;   /*!< Unique ID of Watchpoint. */
   static int next_id;   /*!< ID of next Watchpoint that will be created. */
   std::string counter_name;    /*!< Name of counter the Watchpoint is set on. */
+  NameTable::Id counter_id;    /*!< Interned counter_name. */
 };
 
 };  // namespace db
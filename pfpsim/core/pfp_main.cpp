@@ -29,14 +29,25 @@
  */
 
 #include <getopt.h>
+#include <algorithm>
 #include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 #include <string>
+#include "ConfigurationCache.h"
+#include "Logger.h"
 #include "PFPConfig.h"
 #include "PFPContext.h"
+#include "SweepRunner.h"
 
+using pfp::core::ConfigurationCache;
+using pfp::core::Logger;
+using pfp::core::LogRoute;
 using pfp::core::PFPConfig;
 using pfp::core::PFPContext;
+using pfp::core::SweepRunner;
 
 void exit_usage(const char * name) {
   cout << "PFPSim-generated simulation model:" << endl
@@ -44,6 +55,10 @@ void exit_usage(const char * name) {
       << "   " << name
       << " [(-c|--config-root) <path>] [(-v|--verbosity) ] [-X<option>]+"
       << endl
+      << "      [(-s|--config-snapshot) <file> [--compile-config]]" << endl
+      << "      [--sweep <file> [(-j|--jobs) <n>]] [--async-log]" << endl
+      << "      [--log-route <module>[:<levels>[:<file>[:<rate>[:<burst>]]]]]+"
+      << endl
       << "   " << name << " --help|-h" << endl;
   exit(1);
 }
@@ -52,7 +67,13 @@ void parse_args(int argc, char **argv, std::string & config,
       std::string& verbose_level,
       std::vector<std::string> & user_args,
       std::string& outputdir,
-      bool& debugger_enabled) {
+      bool& debugger_enabled,
+      std::string& config_snapshot,
+      bool& compile_config,
+      std::string& sweep,
+      unsigned& jobs,
+      bool& async_log,
+      std::vector<std::string>& log_routes) {
   static struct option long_options[] = {
       {"config-root" , required_argument , 0 , 'c' } ,
       {"verbosity"   , required_argument , 0 , 'v' } ,
@@ -60,14 +81,22 @@ void parse_args(int argc, char **argv, std::string & config,
       {"output"      , required_argument , 0 , 'o' } ,
       {"debugger"     , no_argument      , 0 , 'd' } ,
       {"UserOpt"     , optional_argument , 0 , 'X' } ,
+      {"config-snapshot", required_argument , 0 , 's' } ,
+      {"compile-config" , no_argument       , 0 , 'C' } ,
+      {"sweep"       , required_argument , 0 , 'S' } ,
+      {"jobs"        , required_argument , 0 , 'j' } ,
+      {"async-log"   , no_argument       , 0 , 'A' } ,
+      {"log-route"   , required_argument , 0 , 'R' } ,
       {0             , 0                 , 0 ,  0  }
   };
   int c;
   const char * config_root = NULL;
   const char * verbosity = NULL;
   const char * output = NULL;
+  const char * snapshot = NULL;
+  const char * sweep_spec = NULL;
   do {
-    c = getopt_long(argc, argv, "hc:X:v:o:d", long_options, NULL);
+    c = getopt_long(argc, argv, "hc:X:v:o:ds:j:", long_options, NULL);
     switch (c) {
     case 'h':
       // If they want help give it to them then exit
@@ -94,6 +123,35 @@ void parse_args(int argc, char **argv, std::string & config,
         exit_usage(argv[0]);  // Make sure it's only specified once in the input
       }
       break;
+    case 's':
+      if (snapshot == NULL) {
+        snapshot = optarg;
+      } else {
+        exit_usage(argv[0]);  // Make sure it's only specified once in the input
+      }
+      break;
+    case 'C':
+      compile_config = true;
+      break;
+    case 'S':
+      if (sweep_spec == NULL) {
+        sweep_spec = optarg;
+      } else {
+        exit_usage(argv[0]);  // Make sure it's only specified once in the input
+      }
+      break;
+    case 'A':
+      async_log = true;
+      break;
+    case 'R':
+      log_routes.push_back(optarg);
+      break;
+    case 'j':
+      jobs = std::strtoul(optarg, NULL, 10);
+      if (jobs == 0) {
+        exit_usage(argv[0]);
+      }
+      break;
     case 'X':
       user_args.push_back(std::string(optarg)+"="+std::string(argv[optind++]));
       break;
@@ -126,20 +184,58 @@ void parse_args(int argc, char **argv, std::string & config,
   if (!output) {
     output = "./";
   }
+  if (compile_config && !snapshot) {
+    cout << "--compile-config requires --config-snapshot" << endl;
+    exit_usage(argv[0]);
+  }
   config = config_root;
   verbose_level = verbosity;
   outputdir = output;
+  if (snapshot) {
+    config_snapshot = snapshot;
+  }
+  if (sweep_spec) {
+    sweep = sweep_spec;
+  }
 }
 
 extern int pfp_main(int sc_argc, char* sc_argv[]);
 
+namespace {
+//! Set by pfp_pause so pfp_start can tell a pause from the end of simulation
+bool pause_requested = false;
+//! Set when the configuration snapshot was loaded and is up to date
+bool snapshot_loaded = false;
+}  // namespace
+
 void pfp_pause() {
+  pause_requested = true;
   sc_pause();
 }
 
 void pfp_start() {
   PFPContext::get_current_context().ensure_top_initialized();
+  // Elaboration has loaded the whole configuration by now
+  auto& config = PFPConfig::get();
+  const std::string snapshot = config.getConfigSnapshotPath();
+  if (!snapshot.empty()
+        && (!snapshot_loaded || config.compile_config_only())) {
+    if (ConfigurationCache::get().save_snapshot(snapshot)) {
+      snapshot_loaded = true;
+      cout << "Configuration snapshot written to: " << snapshot << endl;
+    } else {
+      cerr << "Warning: cannot write configuration snapshot " << snapshot
+          << endl;
+    }
+  }
+  if (config.compile_config_only()) {
+    exit(0);
+  }
+  pause_requested = false;
   sc_start();
+  if (!pause_requested) {
+    PFPContext::get_current_context().end_of_simulation();
+  }
 }
 
 /**
@@ -155,13 +251,56 @@ int pfp_elab_and_sim(int sc_argc, char* sc_argv[]) {
   std::string verbosity_level;
   std::string output_dir;
   bool debugger_enabled = false;
+  std::string config_snapshot;
+  bool compile_config = false;
+  std::string sweep;
+  unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+  bool async_log = false;
+  std::vector<std::string> log_routes;
 
   parse_args(sc_argc, sc_argv,
             config_root,
             verbosity_level,
             user_args,
             output_dir,
-            debugger_enabled);
+            debugger_enabled,
+            config_snapshot,
+            compile_config,
+            sweep,
+            jobs,
+            async_log,
+            log_routes);
+
+  if (!sweep.empty()) {
+    // Fork one child per point; the children continue below as ordinary
+    // runs with their own output directory and -X arguments
+    std::unique_ptr<SweepRunner> sweep_runner;
+    try {
+      sweep_runner.reset(new SweepRunner(sweep));
+    } catch (const std::exception& e) {
+      cout << "Sweep " << sweep << ": " << e.what() << endl;
+      exit_usage(sc_argv[0]);
+    }
+    SweepRunner& runner = *sweep_runner;
+    cout << "Sweep " << sweep << ": " << runner.points().size()
+        << " points, " << jobs << " jobs" << endl;
+    const int point = runner.run(output_dir, jobs);
+    if (point < 0) {
+      cout << "Sweep results: " << runner.collect(output_dir) << endl;
+      for (int status : runner.status()) {
+        if (status != 0) {
+          return 1;
+        }
+      }
+      return 0;
+    }
+    output_dir = SweepRunner::point_directory(output_dir, point);
+    for (auto& value : runner.points()[point]) {
+      user_args.push_back(value.first + "=" + value.second);
+    }
+    // The parent collects the final counters of each point
+    PFPConfig::get().set_export_counter_totals(true);
+  }
 
   size_t slash_pos = config_root.rfind('/');
 
@@ -184,6 +323,29 @@ int pfp_elab_and_sim(int sc_argc, char* sc_argv[]) {
   SPSETOUTPUTDIRPATH(output_dir);
   SPSETARGS(user_args);
   SET_PFP_DEBUGGER_FLAG(debugger_enabled);
+  for (auto& route : log_routes) {
+    try {
+      Logger::get().add_route(LogRoute::parse(route));
+    } catch (const std::invalid_argument& e) {
+      cout << e.what() << endl;
+      exit_usage(sc_argv[0]);
+    }
+  }
+  if (async_log) {
+    // Log statements go to OUTPUTDIR/npulog.txt from here on
+    Logger::get().open();
+  }
+
+  if (!config_snapshot.empty()) {
+    PFPConfig::get().SetConfigSnapshotPath(config_snapshot);
+    PFPConfig::get().set_compile_config_only(compile_config);
+    if (!compile_config) {
+      snapshot_loaded = ConfigurationCache::get().load_snapshot(
+            config_snapshot);
+      cout << "Configuration snapshot " << config_snapshot
+          << (snapshot_loaded ? " loaded" : " missing or out of date") << endl;
+    }
+  }
 
   auto returnval = pfp_main(sc_argc, sc_argv);
 
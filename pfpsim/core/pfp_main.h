@@ -40,7 +40,13 @@ void parse_args(int argc, char **argv, std::string & config,
       std::string& verbose_level,
       std::vector<std::string> & user_args,
       std::string& outputdir,
-      bool& debugger_enabled);
+      bool& debugger_enabled,
+      std::string& config_snapshot,
+      bool& compile_config,
+      std::string& sweep,
+      unsigned& jobs,
+      bool& async_log,
+      std::vector<std::string>& log_routes);
 
 
 void pfp_pause();
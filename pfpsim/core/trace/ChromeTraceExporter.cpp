@@ -0,0 +1,237 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "ChromeTraceExporter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "../json.hpp"
+#include "../PFPConfig.h"
+#include "../PFPContext.h"
+#include "../StringUtils.h"
+
+namespace pfp {
+namespace core {
+namespace trace {
+
+namespace {
+//! Size of the output stream buffer
+const std::size_t buffer_size = 1 << 20;
+
+std::string quoted(const std::string& text) {
+  return nlohmann::json(text).dump();
+}
+}  // namespace
+
+ChromeTraceExporter::ChromeTraceExporter(const std::string& name,
+      const std::string& directory)
+  : buffer_(buffer_size), first_record_(true), closed_(false),
+    us_per_time_unit_(sc_get_default_time_unit().to_seconds() * 1e6),
+    last_ts_(0), next_id_(1) {
+  const std::string path = join_path(
+        directory.empty() ? OUTPUTDIR : directory, name);
+  out_.rdbuf()->pubsetbuf(buffer_.data(), buffer_.size());
+  out_.open(path.c_str());
+  if (!out_) {
+    std::stringstream err;
+    err << "ChromeTraceExporter: cannot create " << path << ": "
+        << std::strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+  // Timestamps are in microseconds, keep nanosecond resolution
+  out_ << std::fixed;
+  out_.precision(3);
+  out_ << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  end_of_simulation_handle_ = PFPContext::get_current_context()
+        .at_end_of_simulation([this]() { close(); });
+}
+
+ChromeTraceExporter::~ChromeTraceExporter() {
+  PFPContext::get_current_context().cancel_end_of_simulation(
+        end_of_simulation_handle_);
+  close();
+}
+
+void ChromeTraceExporter::observe(const ObserverEvent& event) {
+  if (closed_) {
+    return;
+  }
+  const double ts = event.time * us_per_time_unit_;
+  last_ts_ = std::max(last_ts_, ts);
+  switch (event.kind) {
+    case ObserverEvent::Kind::ThreadBegin: {
+      const int pid = process(event.name);
+      slice_begin(pid, thread_track(pid, event.module, event.value),
+            event.packet, ts);
+      break;
+    }
+    case ObserverEvent::Kind::ThreadEnd: {
+      const int pid = process(event.name);
+      slice_end(thread_track(pid, event.module, event.value), ts);
+      break;
+    }
+    case ObserverEvent::Kind::ThreadIdle: {
+      const int pid = process(event.name);
+      const int tid = thread_track(pid, event.module, event.value);
+      slice_end(tid, ts);
+      instant(pid, tid, "idle", ts);
+      break;
+    }
+    case ObserverEvent::Kind::CoreBusy: {
+      const int pid = process(event.name);
+      const int tid = core_track(pid, event.module);
+      slice_begin(pid, tid, ~static_cast<uint64_t>(0), ts);
+      break;
+    }
+    case ObserverEvent::Kind::CoreIdle: {
+      const int pid = process(event.name);
+      slice_end(core_track(pid, event.module), ts);
+      break;
+    }
+    case ObserverEvent::Kind::CounterAdded:
+    case ObserverEvent::Kind::CounterUpdated:
+      counter(event, ts);
+      break;
+    default:
+      break;
+  }
+}
+
+void ChromeTraceExporter::close() {
+  if (closed_) {
+    return;
+  }
+  // Slices still open at the end of the simulation end with the last event
+  while (!open_.empty()) {
+    slice_end(open_.begin()->first, last_ts_);
+  }
+  out_ << "\n]}" << std::endl;
+  out_.close();
+  closed_ = true;
+}
+
+int ChromeTraceExporter::process(NameTable::Id name) {
+  auto it = processes_.find(name);
+  if (it != processes_.end()) {
+    return it->second;
+  }
+  const int pid = next_id_++;
+  processes_.emplace(name, pid);
+  metadata("process_name", pid, 0, NameTable::get().name(name));
+  return pid;
+}
+
+int ChromeTraceExporter::thread_track(int pid, NameTable::Id teu,
+      uint64_t thread) {
+  const auto key = std::make_tuple(pid, teu, thread);
+  auto it = thread_tracks_.find(key);
+  if (it != thread_tracks_.end()) {
+    return it->second;
+  }
+  const int tid = next_id_++;
+  thread_tracks_.emplace(key, tid);
+  metadata("thread_name", pid, tid, NameTable::get().name(teu)
+        + " thread " + std::to_string(thread));
+  return tid;
+}
+
+int ChromeTraceExporter::core_track(int pid, NameTable::Id teu) {
+  const uint64_t key = (static_cast<uint64_t>(pid) << 32) | teu;
+  auto it = core_tracks_.find(key);
+  if (it != core_tracks_.end()) {
+    return it->second;
+  }
+  const int tid = next_id_++;
+  core_tracks_.emplace(key, tid);
+  metadata("thread_name", pid, tid, NameTable::get().name(teu) + " core");
+  return tid;
+}
+
+void ChromeTraceExporter::slice_begin(int pid, int tid, uint64_t packet,
+      double ts) {
+  // A begin without an end (e.g. a preempted thread) ends the last slice
+  slice_end(tid, ts);
+  open_.emplace(tid, OpenSlice{pid, ts, packet});
+}
+
+void ChromeTraceExporter::slice_end(int tid, double ts) {
+  auto it = open_.find(tid);
+  if (it == open_.end()) {
+    return;
+  }
+  const OpenSlice& slice = it->second;
+  begin_record();
+  out_ << "{\"ph\":\"X\",\"pid\":" << slice.pid << ",\"tid\":" << tid
+       << ",\"ts\":" << slice.start << ",\"dur\":" << ts - slice.start;
+  if (slice.packet == ~static_cast<uint64_t>(0)) {
+    out_ << ",\"name\":\"busy\"}";
+  } else {
+    out_ << ",\"name\":\"packet " << slice.packet
+         << "\",\"args\":{\"packet\":" << slice.packet << "}}";
+  }
+  open_.erase(it);
+}
+
+void ChromeTraceExporter::counter(const ObserverEvent& event, double ts) {
+  const int pid = process(event.module);
+  const std::string name = quoted(NameTable::get().name(event.name));
+  begin_record();
+  out_ << "{\"ph\":\"C\",\"pid\":" << pid << ",\"ts\":" << ts
+       << ",\"name\":" << name << ",\"args\":{" << name << ":" << event.value
+       << "}}";
+}
+
+void ChromeTraceExporter::instant(int pid, int tid, const char* name,
+      double ts) {
+  begin_record();
+  out_ << "{\"ph\":\"i\",\"s\":\"t\",\"pid\":" << pid << ",\"tid\":" << tid
+       << ",\"ts\":" << ts << ",\"name\":\"" << name << "\"}";
+}
+
+void ChromeTraceExporter::metadata(const char* what, int pid, int tid,
+      const std::string& name) {
+  begin_record();
+  out_ << "{\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+       << ",\"name\":\"" << what << "\",\"args\":{\"name\":"
+       << quoted(name.empty() ? "top" : name) << "}}";
+}
+
+void ChromeTraceExporter::begin_record() {
+  out_ << (first_record_ ? "\n" : ",\n");
+  first_record_ = false;
+}
+
+};  // namespace trace
+};  // namespace core
+};  // namespace pfp
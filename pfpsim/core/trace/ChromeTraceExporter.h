@@ -0,0 +1,129 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class ChromeTraceExporter
+ * Observer that turns TEU thread and core activity into a timeline in the
+ * Chrome trace-event JSON format, which chrome://tracing and the Perfetto
+ * UI both open.
+ *  - Every TEC is a process; every TEU thread and TEU core is a track in it.
+ *  - Each thread_begin/thread_end pair becomes a slice named after the
+ *    packet it processed; thread_idle ends the slice and marks an instant.
+ *  - core_busy/core_idle become "busy" slices on the core track.
+ *  - Counters become counter tracks in a process named after their module.
+ * Events are written to disk as they complete; the exporter only keeps the
+ * currently open slices and the track ids in memory.
+ *
+ *   top->attach_observer(std::make_shared<trace::ChromeTraceExporter>());
+ *
+ * writes OUTPUTDIR/timeline.json.
+ */
+#ifndef CORE_TRACE_CHROMETRACEEXPORTER_H_
+#define CORE_TRACE_CHROMETRACEEXPORTER_H_
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../EventObserver.h"
+#include "../NameTable.h"
+
+namespace pfp {
+namespace core {
+namespace trace {
+
+class ChromeTraceExporter : public EventObserver {
+ public:
+  /**
+   * Construct a ChromeTraceExporter
+   * @param name        Name of the JSON file
+   * @param directory   Directory of the file; OUTPUTDIR when empty
+   */
+  explicit ChromeTraceExporter(const std::string& name = "timeline.json",
+        const std::string& directory = "");
+  ~ChromeTraceExporter();
+
+  void observe(const ObserverEvent& event) override;
+
+  uint32_t interests() const override {
+    return ObserverEvent::Threads | ObserverEvent::Cores
+        | ObserverEvent::Counters;
+  }
+
+  /**
+   * Close the open slices and finish the JSON file; events received
+   * afterwards are ignored
+   */
+  void close();
+
+ private:
+  struct OpenSlice {
+    int pid;
+    double start;       /*!< Timestamp of the slice, in microseconds */
+    uint64_t packet;
+  };
+
+  int process(NameTable::Id name);
+  int thread_track(int pid, NameTable::Id teu, uint64_t thread);
+  int core_track(int pid, NameTable::Id teu);
+  void slice_begin(int pid, int tid, uint64_t packet, double ts);
+  void slice_end(int tid, double ts);
+  void counter(const ObserverEvent& event, double ts);
+  void instant(int pid, int tid, const char* name, double ts);
+  void metadata(const char* what, int pid, int tid, const std::string& name);
+  void begin_record();
+
+  std::ofstream out_;
+  std::vector<char> buffer_;    /*!< Stream buffer of out_ */
+  bool first_record_;
+  bool closed_;
+  double us_per_time_unit_;     /*!< Simulation time unit in microseconds */
+  double last_ts_;              /*!< Latest timestamp seen */
+  std::unordered_map<NameTable::Id, int> processes_;
+  //! Track of each TEU thread, keyed by process, TEU id and thread id
+  std::map<std::tuple<int, NameTable::Id, uint64_t>, int> thread_tracks_;
+  //! Track of each TEU core, keyed by process (high half) and TEU id
+  std::unordered_map<uint64_t, int> core_tracks_;
+  //! Open slice of each track, by tid
+  std::unordered_map<int, OpenSlice> open_;
+  int next_id_;
+  std::size_t end_of_simulation_handle_;
+};
+
+};  // namespace trace
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_TRACE_CHROMETRACEEXPORTER_H_
@@ -0,0 +1,79 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "TraceFormat.h"
+#include <cstdio>
+#include <string>
+
+namespace pfp {
+namespace core {
+namespace trace {
+
+namespace {
+const char* const kind_names[event_kind_count] = {
+  "counter_added",
+  "counter_removed",
+  "counter_updated",
+  "data_written",
+  "data_read",
+  "data_dropped",
+  "thread_begin",
+  "thread_end",
+  "thread_idle",
+  "core_busy",
+  "core_idle"
+};
+}  // namespace
+
+const char* event_kind_name(EventKind kind) {
+  const std::size_t index = static_cast<std::size_t>(kind);
+  return index < event_kind_count ? kind_names[index] : "unknown";
+}
+
+bool parse_event_kind(const std::string& name, EventKind* kind) {
+  for (std::size_t i = 0; i < event_kind_count; ++i) {
+    if (name == kind_names[i]) {
+      *kind = static_cast<EventKind>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string chunk_path(const std::string& prefix, uint32_t index) {
+  char suffix[32];
+  std::snprintf(suffix, sizeof(suffix), ".%05u.pfptrace", index);
+  return prefix + suffix;
+}
+
+};  // namespace trace
+};  // namespace core
+};  // namespace pfp
@@ -0,0 +1,156 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @file TraceFormat.h
+ * On-disk layout of the binary event traces written by TraceRecorder and
+ * read back by TraceReader.
+ *
+ * A trace is a sequence of chunk files <prefix>.<index>.pfptrace, numbered
+ * from 00000. Each chunk starts with a ChunkHeader followed by 8-byte
+ * aligned records:
+ *  - StringRecord: defines the name of a string id, followed by the bytes of
+ *    the string, zero-padded to a multiple of 8. Every id is defined in a
+ *    chunk before the first event of that chunk that uses it, so chunks can
+ *    be read independently.
+ *  - EventRecord: one observer event, with strings given by id.
+ * A record type of 0 marks the end of the chunk; it is only seen in chunks
+ * that were not closed cleanly (header length 0), whose tail is zero-filled.
+ * All fields are in the byte order of the host that wrote the trace.
+ *
+ * This header does not depend on SystemC so that the reader library and the
+ * pfptrace tool can be built without it.
+ */
+#ifndef CORE_TRACE_TRACEFORMAT_H_
+#define CORE_TRACE_TRACEFORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pfp {
+namespace core {
+namespace trace {
+
+const char chunk_magic[8] = {'P', 'F', 'P', 'T', 'R', 'A', 'C', 'E'};
+const uint32_t format_version = 1;
+
+//! Event kinds; same values as ObserverEvent::Kind
+enum class EventKind : uint8_t {
+  CounterAdded,
+  CounterRemoved,
+  CounterUpdated,
+  DataWritten,
+  DataRead,
+  DataDropped,
+  ThreadBegin,
+  ThreadEnd,
+  ThreadIdle,
+  CoreBusy,
+  CoreIdle
+};
+
+const std::size_t event_kind_count = 11;
+
+/**
+ * Name of an event kind, as used by the pfptrace tool
+ * @param kind  Event kind
+ * @return      Name, e.g. "counter_updated"
+ */
+const char* event_kind_name(EventKind kind);
+
+/**
+ * Parse the name of an event kind
+ * @param name  Name as returned by event_kind_name
+ * @param kind  Output argument
+ * @return      True if name is a known kind
+ */
+bool parse_event_kind(const std::string& name, EventKind* kind);
+
+enum class RecordType : uint8_t {
+  End = 0,
+  String = 1,
+  Event = 2
+};
+
+struct ChunkHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t index;     /*!< Position of the chunk in the trace */
+  uint64_t length;    /*!< Bytes used, header included; 0 if not closed */
+};
+
+struct StringRecord {
+  uint8_t type;       /*!< RecordType::String */
+  uint8_t reserved[3];
+  uint32_t id;
+  uint32_t length;    /*!< Bytes of string data following the record */
+  uint32_t reserved2;
+};
+
+/**
+ * Fields have the same meaning as in ObserverEvent; data_type is the
+ * TrType::data_type of the data of Data* events, and packet their id
+ */
+struct EventRecord {
+  uint8_t type;       /*!< RecordType::Event */
+  uint8_t kind;       /*!< EventKind */
+  uint16_t reserved;
+  uint32_t module;
+  uint32_t name;
+  uint32_t data_type;
+  uint64_t value;
+  uint64_t packet;
+  double time;
+};
+
+static_assert(sizeof(ChunkHeader) == 24, "ChunkHeader layout changed");
+static_assert(sizeof(StringRecord) == 16, "StringRecord layout changed");
+static_assert(sizeof(EventRecord) == 40, "EventRecord layout changed");
+
+//! Size of a string record including its padded string data
+inline std::size_t string_record_size(std::size_t length) {
+  return sizeof(StringRecord) + ((length + 7) & ~static_cast<std::size_t>(7));
+}
+
+/**
+ * Path of one chunk of a trace
+ * @param prefix  Trace path without the chunk suffix, e.g. "output/trace"
+ * @param index   Chunk index
+ * @return        e.g. "output/trace.00003.pfptrace"
+ */
+std::string chunk_path(const std::string& prefix, uint32_t index);
+
+};  // namespace trace
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_TRACE_TRACEFORMAT_H_
@@ -0,0 +1,248 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "TraceReader.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace pfp {
+namespace core {
+namespace trace {
+
+namespace {
+const std::string empty_string;
+
+std::runtime_error trace_error(const std::string& path,
+      const std::string& what) {
+  return std::runtime_error("TraceReader: " + path + ": " + what);
+}
+}  // namespace
+
+bool TraceFilter::matches(const TraceEvent& event) const {
+  if (!(kinds & (1u << static_cast<uint32_t>(event.kind)))) {
+    return false;
+  }
+  if (event.time < from || event.time > to) {
+    return false;
+  }
+  if (!module.empty() && event.module->find(module) == std::string::npos) {
+    return false;
+  }
+  if (!name.empty() && event.name->find(name) == std::string::npos) {
+    return false;
+  }
+  return true;
+}
+
+TraceReader::TraceReader(const std::string& prefix) {
+  struct stat info;
+  for (uint32_t index = 0; ; ++index) {
+    std::string path = chunk_path(prefix, index);
+    if (::stat(path.c_str(), &info) != 0) {
+      break;
+    }
+    chunks_.push_back(path);
+  }
+  if (chunks_.empty()) {
+    throw trace_error(chunk_path(prefix, 0), "no such trace");
+  }
+}
+
+uint64_t TraceReader::read(std::function<void(const TraceEvent&)> callback,
+      const TraceFilter& filter) const {
+  uint64_t count = 0;
+  for (auto& path : chunks_) {
+    count += read_chunk(path, callback, filter);
+  }
+  return count;
+}
+
+uint64_t TraceReader::read_chunk(const std::string& path,
+      const std::function<void(const TraceEvent&)>& callback,
+      const TraceFilter& filter) const {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  struct stat info;
+  if (fd < 0 || ::fstat(fd, &info) != 0) {
+    const std::string reason = std::strerror(errno);
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    throw trace_error(path, reason);
+  }
+  const std::size_t size = info.st_size;
+  if (size < sizeof(ChunkHeader)) {
+    ::close(fd);
+    throw trace_error(path, "truncated chunk header");
+  }
+  void* map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    throw trace_error(path, std::strerror(errno));
+  }
+  const char* base = static_cast<const char*>(map);
+  // Unmap on every way out of this function
+  std::unique_ptr<void, std::function<void(void*)>> unmap(map,
+        [size](void* p) { ::munmap(p, size); });
+
+  ChunkHeader header;
+  std::memcpy(&header, base, sizeof(header));
+  if (std::memcmp(header.magic, chunk_magic, sizeof(chunk_magic)) != 0) {
+    throw trace_error(path, "not a pfpsim trace");
+  }
+  if (header.version != format_version) {
+    throw trace_error(path, "unsupported trace version "
+          + std::to_string(header.version));
+  }
+  const std::size_t end = (header.length && header.length <= size)
+        ? header.length : size;
+
+  std::vector<std::string> strings;
+  auto lookup = [&strings](uint32_t id) -> const std::string* {
+    return id < strings.size() ? &strings[id] : &empty_string;
+  };
+  uint64_t count = 0;
+  std::size_t offset = sizeof(ChunkHeader);
+  while (offset + sizeof(StringRecord) <= end) {
+    const RecordType type = static_cast<RecordType>(base[offset]);
+    if (type == RecordType::End) {
+      break;
+    } else if (type == RecordType::String) {
+      StringRecord record;
+      std::memcpy(&record, base + offset, sizeof(record));
+      const std::size_t record_size = string_record_size(record.length);
+      if (offset + record_size > end) {
+        throw trace_error(path, "truncated string record");
+      }
+      if (record.id >= strings.size()) {
+        strings.resize(record.id + 1);
+      }
+      strings[record.id].assign(base + offset + sizeof(record),
+            record.length);
+      offset += record_size;
+    } else if (type == RecordType::Event) {
+      if (offset + sizeof(EventRecord) > end) {
+        throw trace_error(path, "truncated event record");
+      }
+      EventRecord record;
+      std::memcpy(&record, base + offset, sizeof(record));
+      offset += sizeof(record);
+      TraceEvent event;
+      event.kind = static_cast<EventKind>(record.kind);
+      event.module = lookup(record.module);
+      event.name = lookup(record.name);
+      event.data_type = lookup(record.data_type);
+      event.value = record.value;
+      event.packet = record.packet;
+      event.time = record.time;
+      if (filter.matches(event)) {
+        callback(event);
+        ++count;
+      }
+    } else {
+      std::stringstream err;
+      err << "bad record type " << static_cast<int>(type) << " at offset "
+          << offset;
+      throw trace_error(path, err.str());
+    }
+  }
+  return count;
+}
+
+void TraceSummary::add(const TraceEvent& event) {
+  if (events_ == 0 || event.time < first_) {
+    first_ = event.time;
+  }
+  if (events_ == 0 || event.time > last_) {
+    last_ = event.time;
+  }
+  ++events_;
+  const std::size_t kind = static_cast<std::size_t>(event.kind);
+  if (kind < event_kind_count) {
+    ++overall_.per_kind[kind];
+    ++modules_[*event.module].per_kind[kind];
+  }
+  ++overall_.total;
+  ++modules_[*event.module].total;
+  if (event.kind == EventKind::CounterUpdated
+        || event.kind == EventKind::CounterAdded) {
+    counters_[std::make_pair(*event.module, *event.name)] = event.value;
+  }
+}
+
+void TraceSummary::print(std::ostream& os) const {
+  os << "events: " << events_ << std::endl;
+  if (events_ == 0) {
+    return;
+  }
+  os << "time:   " << first_ << " .. " << last_ << std::endl;
+  os << std::endl << "per kind:" << std::endl;
+  for (std::size_t kind = 0; kind < event_kind_count; ++kind) {
+    if (overall_.per_kind[kind]) {
+      os << "  " << std::left << std::setw(18)
+         << event_kind_name(static_cast<EventKind>(kind))
+         << std::right << overall_.per_kind[kind] << std::endl;
+    }
+  }
+  os << std::endl << "per module:" << std::endl;
+  for (auto& module : modules_) {
+    os << "  " << (module.first.empty() ? "<none>" : module.first) << ": "
+       << module.second.total << std::endl;
+    for (std::size_t kind = 0; kind < event_kind_count; ++kind) {
+      if (module.second.per_kind[kind]) {
+        os << "    " << std::left << std::setw(16)
+           << event_kind_name(static_cast<EventKind>(kind))
+           << std::right << module.second.per_kind[kind] << std::endl;
+      }
+    }
+  }
+  if (!counters_.empty()) {
+    os << std::endl << "final counter values:" << std::endl;
+    for (auto& counter : counters_) {
+      os << "  " << counter.first.first << "." << counter.first.second
+         << " = " << counter.second << std::endl;
+    }
+  }
+}
+
+};  // namespace trace
+};  // namespace core
+};  // namespace pfp
@@ -0,0 +1,151 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class TraceReader
+ * Reads back the binary traces written by TraceRecorder.
+ * The chunks are memory mapped and decoded one event at a time; events are
+ * passed to a callback together with their resolved strings, optionally
+ * filtered by a TraceFilter. TraceSummary aggregates a trace into per
+ * module and per kind counts. None of this depends on SystemC, the pfptrace
+ * tool is built on this class.
+ */
+#ifndef CORE_TRACE_TRACEREADER_H_
+#define CORE_TRACE_TRACEREADER_H_
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "TraceFormat.h"
+
+namespace pfp {
+namespace core {
+namespace trace {
+
+//! One decoded event; the strings are only valid during the callback
+struct TraceEvent {
+  EventKind kind;
+  const std::string* module;
+  const std::string* name;
+  const std::string* data_type;
+  uint64_t value;
+  uint64_t packet;
+  double time;
+};
+
+/**
+ * Selects events by kind, module, name and time. Module and name match
+ * when they contain the given text; empty text matches everything.
+ */
+struct TraceFilter {
+  uint32_t kinds = ~0u;         /*!< Bit (1 << kind) for each kind to keep */
+  std::string module;
+  std::string name;
+  double from = -std::numeric_limits<double>::infinity();
+  double to = std::numeric_limits<double>::infinity();
+
+  bool matches(const TraceEvent& event) const;
+};
+
+class TraceReader {
+ public:
+  /**
+   * Construct a TraceReader
+   * @param prefix  Trace path without the chunk suffix, e.g. "output/trace"
+   */
+  explicit TraceReader(const std::string& prefix);
+
+  /**
+   * Chunk files of the trace, in order
+   */
+  const std::vector<std::string>& chunks() const {
+    return chunks_;
+  }
+
+  /**
+   * Decode every event of the trace, in order
+   * @param callback  Called for each event that passes the filter
+   * @param filter    Events to keep (default: all)
+   * @return          Number of events passed to callback
+   */
+  uint64_t read(std::function<void(const TraceEvent&)> callback,
+        const TraceFilter& filter = TraceFilter()) const;
+
+ private:
+  uint64_t read_chunk(const std::string& path,
+        const std::function<void(const TraceEvent&)>& callback,
+        const TraceFilter& filter) const;
+
+  std::vector<std::string> chunks_;
+};
+
+/**
+ * Event counts and time span of a trace, per kind and per module
+ */
+class TraceSummary {
+ public:
+  void add(const TraceEvent& event);
+
+  /**
+   * Print the summary as text
+   * @param os  Output stream
+   */
+  void print(std::ostream& os) const;
+
+  uint64_t events() const {
+    return events_;
+  }
+
+ private:
+  struct Counts {
+    uint64_t per_kind[event_kind_count] = {};
+    uint64_t total = 0;
+  };
+
+  uint64_t events_ = 0;
+  double first_ = 0;
+  double last_ = 0;
+  Counts overall_;
+  std::map<std::string, Counts> modules_;
+  //! Last value of every counter, keyed by (module, counter)
+  std::map<std::pair<std::string, std::string>, uint64_t> counters_;
+};
+
+};  // namespace trace
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_TRACE_TRACEREADER_H_
@@ -0,0 +1,202 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include "TraceRecorder.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "../PFPConfig.h"
+#include "../PFPContext.h"
+#include "../StringUtils.h"
+
+namespace pfp {
+namespace core {
+namespace trace {
+
+static_assert(static_cast<int>(ObserverEvent::Kind::CoreIdle)
+      == static_cast<int>(EventKind::CoreIdle),
+      "trace::EventKind must mirror ObserverEvent::Kind");
+
+TraceRecorder::TraceRecorder(const std::string& name, std::size_t chunk_size,
+      const std::string& directory)
+  : chunk_size_(chunk_size), fd_(-1), base_(nullptr), used_(0),
+    chunk_index_(0), closed_(false), events_(0) {
+  if (chunk_size_ < sizeof(ChunkHeader) + 4096) {
+    throw std::invalid_argument("TraceRecorder chunk size is too small");
+  }
+  prefix_ = join_path(directory.empty() ? OUTPUTDIR : directory, name);
+  open_chunk();
+  end_of_simulation_handle_ = PFPContext::get_current_context()
+        .at_end_of_simulation([this]() { close(); });
+}
+
+TraceRecorder::~TraceRecorder() {
+  PFPContext::get_current_context().cancel_end_of_simulation(
+        end_of_simulation_handle_);
+  close();
+}
+
+void TraceRecorder::observe(const ObserverEvent& event) {
+  if (closed_) {
+    return;
+  }
+  const NameTable::Id data_type = event.data
+        ? NameTable::get().intern(event.data->data_type()) : 0;
+  std::size_t needed = sizeof(EventRecord) + string_bytes(event.module)
+        + string_bytes(event.name) + string_bytes(data_type);
+  if (used_ + needed > chunk_size_) {
+    close_chunk();
+    ++chunk_index_;
+    open_chunk();
+    needed = sizeof(EventRecord) + string_bytes(event.module)
+          + string_bytes(event.name) + string_bytes(data_type);
+    if (used_ + needed > chunk_size_) {
+      return;  // names longer than a whole chunk
+    }
+  }
+  write_string(event.module);
+  write_string(event.name);
+  write_string(data_type);
+
+  EventRecord record;
+  record.type = static_cast<uint8_t>(RecordType::Event);
+  record.kind = static_cast<uint8_t>(event.kind);
+  record.reserved = 0;
+  record.module = event.module;
+  record.name = event.name;
+  record.data_type = data_type;
+  record.value = event.value;
+  record.packet = event.data ? event.data->id() : event.packet;
+  record.time = event.time;
+  std::memcpy(base_ + used_, &record, sizeof(record));
+  used_ += sizeof(record);
+  ++events_;
+}
+
+void TraceRecorder::close() {
+  if (!closed_) {
+    close_chunk();
+    closed_ = true;
+  }
+}
+
+void TraceRecorder::open_chunk() {
+  const std::string path = chunk_path(prefix_, chunk_index_);
+  fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0 || ::ftruncate(fd_, chunk_size_) != 0) {
+    std::stringstream err;
+    err << "TraceRecorder: cannot create " << path << ": "
+        << std::strerror(errno);
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+    closed_ = true;
+    throw std::runtime_error(err.str());
+  }
+  void* map = ::mmap(nullptr, chunk_size_, PROT_READ | PROT_WRITE,
+        MAP_SHARED, fd_, 0);
+  if (map == MAP_FAILED) {
+    std::stringstream err;
+    err << "TraceRecorder: cannot map " << path << ": "
+        << std::strerror(errno);
+    ::close(fd_);
+    fd_ = -1;
+    closed_ = true;
+    throw std::runtime_error(err.str());
+  }
+  base_ = static_cast<char*>(map);
+
+  ChunkHeader header;
+  std::memcpy(header.magic, chunk_magic, sizeof(header.magic));
+  header.version = format_version;
+  header.index = chunk_index_;
+  header.length = 0;
+  std::memcpy(base_, &header, sizeof(header));
+  used_ = sizeof(header);
+  defined_.assign(defined_.size(), false);
+}
+
+void TraceRecorder::close_chunk() {
+  if (fd_ < 0) {
+    return;
+  }
+  const uint64_t length = used_;
+  std::memcpy(base_ + offsetof(ChunkHeader, length), &length,
+        sizeof(length));
+  ::munmap(base_, chunk_size_);
+  if (::ftruncate(fd_, used_) != 0) {
+    std::cerr << "TraceRecorder: cannot trim "
+        << chunk_path(prefix_, chunk_index_) << ": "
+        << std::strerror(errno) << std::endl;
+  }
+  ::close(fd_);
+  fd_ = -1;
+  base_ = nullptr;
+}
+
+std::size_t TraceRecorder::string_bytes(NameTable::Id id) const {
+  if (id < defined_.size() && defined_[id]) {
+    return 0;
+  }
+  return string_record_size(NameTable::get().name(id).size());
+}
+
+void TraceRecorder::write_string(NameTable::Id id) {
+  if (id >= defined_.size()) {
+    defined_.resize(id + 1, false);
+  }
+  if (defined_[id]) {
+    return;
+  }
+  const std::string& text = NameTable::get().name(id);
+  StringRecord record;
+  std::memset(&record, 0, sizeof(record));
+  record.type = static_cast<uint8_t>(RecordType::String);
+  record.id = id;
+  record.length = static_cast<uint32_t>(text.size());
+  std::memcpy(base_ + used_, &record, sizeof(record));
+  // The mapping is zero-filled, so the padding after the text already is 0
+  std::memcpy(base_ + used_ + sizeof(record), text.data(), text.size());
+  used_ += string_record_size(text.size());
+  defined_[id] = true;
+}
+
+};  // namespace trace
+};  // namespace core
+};  // namespace pfp
@@ -0,0 +1,114 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/**
+ * @class TraceRecorder
+ * Observer that writes every event it receives to a binary trace (see
+ * TraceFormat.h), for post-mortem analysis with TraceReader or pfptrace.
+ * Chunks are memory mapped, so recording an event is a couple of stores
+ * into the page cache; when a chunk fills up it is trimmed to its used
+ * length and the next one is created. The trace is closed at the end of
+ * the simulation, or when the recorder is destroyed.
+ *
+ *   top->attach_observer(std::make_shared<trace::TraceRecorder>("run"));
+ *
+ * writes OUTPUTDIR/run.00000.pfptrace, OUTPUTDIR/run.00001.pfptrace, ...
+ * Wrap the recorder in an AsyncObserver to take the writes off the
+ * simulation thread.
+ */
+#ifndef CORE_TRACE_TRACERECORDER_H_
+#define CORE_TRACE_TRACERECORDER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../EventObserver.h"
+#include "../NameTable.h"
+#include "TraceFormat.h"
+
+namespace pfp {
+namespace core {
+namespace trace {
+
+class TraceRecorder : public EventObserver {
+ public:
+  /**
+   * Construct a TraceRecorder
+   * @param name        Base name of the chunk files
+   * @param chunk_size  Size of each chunk file in bytes
+   * @param directory   Directory of the trace; OUTPUTDIR when empty
+   */
+  explicit TraceRecorder(const std::string& name = "trace",
+        std::size_t chunk_size = 64 << 20,
+        const std::string& directory = "");
+  ~TraceRecorder();
+
+  void observe(const ObserverEvent& event) override;
+
+  /**
+   * Finish the current chunk; events received afterwards are ignored
+   */
+  void close();
+
+  //! Trace path without the chunk suffix, as expected by TraceReader
+  const std::string& prefix() const {
+    return prefix_;
+  }
+
+  //! Number of events written so far
+  uint64_t events() const {
+    return events_;
+  }
+
+ private:
+  void open_chunk();
+  void close_chunk();
+  std::size_t string_bytes(NameTable::Id id) const;
+  void write_string(NameTable::Id id);
+
+  std::string prefix_;          /*!< Path of the chunks without suffix */
+  const std::size_t chunk_size_;
+  int fd_;                      /*!< Current chunk file, -1 when closed */
+  char* base_;                  /*!< Mapping of the current chunk */
+  std::size_t used_;            /*!< Bytes written to the current chunk */
+  uint32_t chunk_index_;
+  bool closed_;
+  //! Ids whose StringRecord is already in the current chunk
+  std::vector<bool> defined_;
+  uint64_t events_;
+  std::size_t end_of_simulation_handle_;
+};
+
+};  // namespace trace
+};  // namespace core
+};  // namespace pfp
+
+#endif  // CORE_TRACE_TRACERECORDER_H_
@@ -0,0 +1,193 @@
+/*
+ * PFPSim: Library for the Programmable Forwarding Plane Simulation Framework
+ *
+ * Copyright (C) 2016 Concordia Univ., Montreal
+ *     Samar Abdi
+ *     Umair Aftab
+ *     Gordon Bailey
+ *     Faras Dewal
+ *     Shafigh Parsazad
+ *     Eric Tremblay
+ *
+ * Copyright (C) 2016 Ericsson
+ *     Bochra Boughzala
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/*
+ * pfptrace: filter, summarize and convert the binary traces written by
+ * pfp::core::trace::TraceRecorder, without re-running the simulation.
+ */
+
+#include <getopt.h>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "../json.hpp"
+#include "TraceReader.h"
+
+using pfp::core::trace::EventKind;
+using pfp::core::trace::TraceEvent;
+using pfp::core::trace::TraceFilter;
+using pfp::core::trace::TraceReader;
+using pfp::core::trace::TraceSummary;
+
+namespace {
+
+void exit_usage(const char* name) {
+  std::cout << "Read a PFPSim binary event trace" << std::endl
+      << "Usage:" << std::endl
+      << "   " << name
+      << " [(-f|--format) summary|csv|json] [(-k|--kind) <kind>[,<kind>]+]"
+      << std::endl
+      << "      [(-m|--module) <text>] [(-n|--name) <text>]"
+      << " [--from <time>] [--to <time>] <trace prefix>" << std::endl
+      << "   " << name << " --help|-h" << std::endl
+      << std::endl
+      << "<trace prefix> is the path of the chunks without the"
+      << " .NNNNN.pfptrace suffix." << std::endl
+      << "Kinds: counter_added counter_removed counter_updated data_written"
+      << std::endl
+      << "       data_read data_dropped thread_begin thread_end thread_idle"
+      << std::endl
+      << "       core_busy core_idle" << std::endl;
+  exit(1);
+}
+
+uint32_t parse_kinds(const std::string& list, const char* name) {
+  uint32_t kinds = 0;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    EventKind kind;
+    if (!pfp::core::trace::parse_event_kind(item, &kind)) {
+      std::cerr << "Unknown event kind: " << item << std::endl;
+      exit_usage(name);
+    }
+    kinds |= 1u << static_cast<uint32_t>(kind);
+  }
+  return kinds;
+}
+
+std::string csv_field(const std::string& text) {
+  if (text.find_first_of(",\"\n") == std::string::npos) {
+    return text;
+  }
+  std::string quoted = "\"";
+  for (char c : text) {
+    if (c == '"') {
+      quoted += '"';
+    }
+    quoted += c;
+  }
+  return quoted + '"';
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  static struct option long_options[] = {
+      {"format" , required_argument , 0 , 'f' } ,
+      {"kind"   , required_argument , 0 , 'k' } ,
+      {"module" , required_argument , 0 , 'm' } ,
+      {"name"   , required_argument , 0 , 'n' } ,
+      {"from"   , required_argument , 0 , 'F' } ,
+      {"to"     , required_argument , 0 , 'T' } ,
+      {"help"   , no_argument       , 0 , 'h' } ,
+      {0        , 0                 , 0 ,  0  }
+  };
+  std::string format = "summary";
+  TraceFilter filter;
+  int opt;
+  while ((opt = getopt_long(argc, argv, "f:k:m:n:h", long_options, nullptr))
+        != -1) {
+    switch (opt) {
+      case 'f':
+        format = optarg;
+        break;
+      case 'k':
+        filter.kinds = parse_kinds(optarg, argv[0]);
+        break;
+      case 'm':
+        filter.module = optarg;
+        break;
+      case 'n':
+        filter.name = optarg;
+        break;
+      case 'F':
+        filter.from = std::strtod(optarg, nullptr);
+        break;
+      case 'T':
+        filter.to = std::strtod(optarg, nullptr);
+        break;
+      default:
+        exit_usage(argv[0]);
+    }
+  }
+  if (optind != argc - 1
+        || (format != "summary" && format != "csv" && format != "json")) {
+    exit_usage(argv[0]);
+  }
+
+  try {
+    TraceReader reader(argv[optind]);
+    if (format == "summary") {
+      TraceSummary summary;
+      reader.read([&summary](const TraceEvent& event) {
+        summary.add(event);
+      }, filter);
+      summary.print(std::cout);
+    } else if (format == "csv") {
+      // Fixed notation: the default six significant digits would round
+      // the times of long runs (1234567 becomes 1.23457e+06)
+      std::cout << std::fixed << std::setprecision(6);
+      std::cout << "time,kind,module,name,data_type,value,packet"
+          << std::endl;
+      reader.read([](const TraceEvent& event) {
+        std::cout << event.time << ','
+            << pfp::core::trace::event_kind_name(event.kind) << ','
+            << csv_field(*event.module) << ',' << csv_field(*event.name)
+            << ',' << csv_field(*event.data_type) << ',' << event.value
+            << ',' << event.packet << '\n';
+      }, filter);
+    } else {
+      bool first = true;
+      std::cout << "[";
+      reader.read([&first](const TraceEvent& event) {
+        nlohmann::json j;
+        j["time"] = event.time;
+        j["kind"] = pfp::core::trace::event_kind_name(event.kind);
+        j["module"] = *event.module;
+        j["name"] = *event.name;
+        j["data_type"] = *event.data_type;
+        j["value"] = event.value;
+        j["packet"] = event.packet;
+        std::cout << (first ? "\n" : ",\n") << j.dump();
+        first = false;
+      }, filter);
+      std::cout << "\n]" << std::endl;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
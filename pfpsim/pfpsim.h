@@ -39,8 +39,28 @@
 #include "core/PacketBase.h"
 #include "core/MTQueue.h"
 #include "core/LMTQueue.h"
+#include "core/RingBuffer.h"
+#include "core/QueueStats.h"
+#include "core/Histogram.h"
+#include "core/SchedulingQueue.h"
+#include "core/DropPolicy.h"
 #include "core/PFPObserver.h"
+#include "core/ObserverEvent.h"
+#include "core/NameTable.h"
+#include "core/ModuleRegistry.h"
+#include "core/CounterHandle.h"
+#include "core/ConcurrentRing.h"
+#include "core/AsyncObserver.h"
+#include "core/EventObserver.h"
+#include "core/UtilizationObserver.h"
+#include "core/LatencyObserver.h"
+#include "core/CounterSampler.h"
+#include "core/SweepRunner.h"
+#include "core/Logger.h"
 #include "core/ConfigurationParameters.h"
+#include "core/ConfigurationCache.h"
+#include "core/ParameterView.h"
+#include "core/ParameterBinding.h"
 #include "core/promptcolors.h"
 #include "core/json.hpp"
 #include "core/DebuggerUtilities.h"
@@ -49,6 +69,11 @@
 //------------------------- core/debugger -------------------------//
 #include "core/debugger/CPDebuggerInterface.h"
 
+//-------------------------- core/trace ---------------------------//
+#include "core/trace/TraceRecorder.h"
+#include "core/trace/TraceReader.h"
+#include "core/trace/ChromeTraceExporter.h"
+
 //---------------------------- core/cp ----------------------------//
 #include "core/cp/Commands.h"
 #include "core/cp/CommandParser.h"